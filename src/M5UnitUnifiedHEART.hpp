@@ -16,6 +16,8 @@
 #include "unit/unit_MAX30100.hpp"
 #include "unit/unit_MAX30102.hpp"
 #include "utility/pulse_monitor.hpp"
+#include "utility/fixed_pulse_monitor.hpp"
+#include "utility/pulse_monitor_bank.hpp"
 
 /*!
   @namespace m5
@@ -0,0 +1,195 @@
+/*
+ * SPDX-FileCopyrightText: 2026 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file fifo_common.cpp
+  @brief Common parts of the FIFO read of MAX30100 and MAX30102
+*/
+#include "fifo_common.hpp"
+#include <M5Utility.hpp>
+#include <algorithm>
+#include <cassert>
+
+namespace m5 {
+namespace unit {
+namespace fifo {
+
+bool read_pointers(Component& unit, const uint8_t status_reg, const uint8_t wptr_reg, const bool status,
+                   const uint8_t depth, uint_fast8_t& count, uint8_t& overflow, uint32_t& wire_bytes)
+{
+    count = overflow = 0;
+
+    uint8_t regs[8]{};
+    const uint8_t rptr_reg = wptr_reg + 2;
+    assert(status_reg < wptr_reg && rptr_reg < sizeof(regs));
+    const uint8_t top = status ? status_reg : wptr_reg;
+    if (!unit.readRegister(top, regs + top, rptr_reg + 1 - top, 0, false /*stop*/)) {
+        return false;
+    }
+    wire_bytes += 2 + 1 + (rptr_reg + 1 - top);  // Address and register, address and data
+    const uint8_t wptr = regs[wptr_reg];
+    overflow           = regs[wptr_reg + 1];
+    const uint8_t rptr = regs[rptr_reg];
+    // Equal pointers mean full rather than empty if A_FULL is asserted
+    const bool full = (wptr == rptr) && (regs[status_reg] & INT_A_FULL);
+
+    count = (overflow || full) ? depth : (wptr >= rptr) ? (wptr - rptr) : (wptr + depth - rptr);
+    assert(count <= depth);
+    return true;
+}
+
+bool read_data(Component& unit, const uint8_t reg, uint8_t* dst, const uint32_t len, const uint32_t sample_length,
+               const uint32_t buffer_length, uint32_t& wire_bytes)
+{
+    // The register address is sent without STOP, and the data follows with the repeated START
+    // FIFO_DATA does not increment the register address, so the chunks continue to read the FIFO
+    if (unit.writeWithTransaction(&reg, 1, 0 /* repeated start */) != m5::hal::error::error_t::OK) {
+        return false;
+    }
+    wire_bytes += 2;
+
+    // Chunks of whole samples as large as the buffer, one transaction if the buffer is enough for all
+    const uint32_t chunk = std::max<uint32_t>(buffer_length - (buffer_length % sample_length), sample_length);
+    uint32_t left        = len;
+    while (left) {
+        const uint32_t batch_len = std::min(left, chunk);
+        if (unit.readWithTransaction(dst, batch_len) != m5::hal::error::error_t::OK) {
+            return false;
+        }
+        wire_bytes += 1 + batch_len;
+        dst += batch_len;
+        left -= batch_len;
+    }
+    return true;
+}
+
+bool modify_register8(Component& unit, const uint8_t reg, const uint8_t set, const uint8_t clear)
+{
+    uint8_t v{};
+    return unit.readRegister8(reg, v, 0, false /*stop*/) &&
+           unit.writeRegister8(reg, static_cast<uint8_t>((v & ~clear) | set));
+}
+
+// class Timeline
+uint32_t Timeline::now() const
+{
+    return micros ? micros(micros_arg) : m5::utility::micros();
+}
+
+void Timeline::restart(const uint32_t period)
+{
+    sample_period = period;
+    read_at       = now();
+    timestamp = gap = sample_index = next_index = pending_gap = 0;
+}
+
+void Timeline::stamp(const uint_fast8_t count, const uint8_t overflow, const uint8_t depth, const bool rollover)
+{
+    const uint32_t at = now();
+    // The overflow counter saturates, so the samples lost beyond it are estimated from the elapsed time
+    uint32_t lost = overflow;
+    if (overflow >= depth - 1 && sample_period) {
+        const uint32_t produced = (at - read_at) / sample_period;
+        lost                    = std::max<uint32_t>(lost, (produced > count) ? produced - count : 0);
+    }
+    read_elapsed = at - read_at;
+    read_at      = at;
+    gap          = rollover ? lost + pending_gap : pending_gap;  // Including the samples discarded by discard()
+    pending_gap  = rollover ? 0 : lost;
+    sample_index = next_index + gap;
+    next_index   = sample_index + count;
+    // The newest sample is at the read, or before the lost samples
+    timestamp = at - (count ? count - 1 + (rollover ? 0 : lost) : 0) * sample_period;
+}
+
+void Timeline::discard(const uint_fast8_t count)
+{
+    const uint32_t at       = now();
+    const uint32_t produced = sample_period ? (at - read_at) / sample_period : 0;
+    read_at                 = at;
+    next_index -= count;
+    pending_gap += count + produced;
+}
+
+// class AsyncRead
+bool AsyncRead::enable(async_read_function_t f, void* a)
+{
+    if (!f) {
+        M5_LIB_LOGE("func must not be nullptr");
+        return false;
+    }
+    func = f;
+    arg  = a;
+    return true;
+}
+
+bool AsyncRead::start(const uint8_t reg, uint8_t* dst, const uint32_t len, const uint8_t samples,
+                      uint32_t& wire_bytes)
+{
+    count        = samples;
+    result       = 0;
+    transferring = true;
+    if (!func(reg, dst, len, arg)) {
+        M5_LIB_LOGE("Failed to start the transfer");
+        transferring = false;
+        return false;
+    }
+    wire_bytes += 2 + 1 + len;  // Register address, and the data with the repeated START
+    return true;
+}
+
+bool AsyncRead::take()
+{
+    if (!transferring || !result) {
+        return false;
+    }
+    transferring = false;
+    if (result < 0) {
+        M5_LIB_LOGE("Failed to read FIFO");
+        return false;
+    }
+    return true;
+}
+
+uint8_t AsyncRead::cancel()
+{
+    transferring = false;
+    result       = 0;
+    return count;
+}
+
+// class AdaptivePolling
+bool AdaptivePolling::enable(const uint8_t level, const uint8_t depth)
+{
+    if (!level || level >= depth) {
+        M5_LIB_LOGE("Valid range 1 - %u %u", depth - 1, level);
+        return false;
+    }
+    enabled = true;
+    target  = level;
+    return true;
+}
+
+// Samples per read scale with the measured time since the previous read (elapsed us), not with the interval, since
+// the caller may poll later than the interval. Move halfway to the estimate to smooth out the jitter of the polling.
+// If samples were lost on time, the estimate is too long (the overflow counter saturates), so at least halve.
+// If the read was late, the caller was the limit rather than the interval, so it is not narrowed
+uint32_t AdaptivePolling::next(const uint32_t interval, const uint32_t elapsed, const uint8_t retrieved,
+                               const uint8_t overflow) const
+{
+    const uint32_t produced = retrieved + overflow;
+    if (!produced || !elapsed) {
+        return interval;
+    }
+    const uint32_t estimated = static_cast<uint32_t>(static_cast<uint64_t>(elapsed) * target / produced / 1000U);
+    const bool late          = elapsed >= interval * 1500U;  // 1.5 times the interval (ms to us)
+    const uint32_t adapted   = overflow ? std::min(late ? interval : interval / 2, estimated)
+                                        : (interval + estimated + 1) / 2;
+    return std::min<uint32_t>(std::max<uint32_t>(adapted, min_interval), max_interval);
+}
+
+}  // namespace fifo
+}  // namespace unit
+}  // namespace m5
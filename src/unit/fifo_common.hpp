@@ -0,0 +1,128 @@
+/*
+ * SPDX-FileCopyrightText: 2026 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file fifo_common.hpp
+  @brief Common parts of the FIFO read of MAX30100 and MAX30102
+*/
+#ifndef M5_UNIT_HEART_FIFO_COMMON_HPP
+#define M5_UNIT_HEART_FIFO_COMMON_HPP
+
+#include <M5UnitComponent.hpp>
+#include <cstdint>
+
+namespace m5 {
+namespace unit {
+///@cond
+namespace fifo {
+
+// FIFO almost full (same bit of the interrupt status and enable on both)
+constexpr uint8_t INT_A_FULL{0x80};
+
+using data_ready_function_t = bool (*)(void* arg);
+using async_read_function_t = bool (*)(const uint8_t reg, uint8_t* dst, const uint32_t len, void* arg);
+
+/*
+  Read FIFO_WRITE_POINTER, FIFO_OVERFLOW_COUNTER and FIFO_READ_POINTER (contiguous from wptr_reg) in one burst
+  With status, the burst starts from the interrupt status at status_reg (0x00) to clear it at the same time
+  count is the number of the samples to read, wire_bytes is added the bytes on the wire
+ */
+bool read_pointers(Component& unit, const uint8_t status_reg, const uint8_t wptr_reg, const bool status,
+                   const uint8_t depth, uint_fast8_t& count, uint8_t& overflow, uint32_t& wire_bytes);
+
+// Read len bytes of FIFO_DATA at reg in chunks of whole samples (sample_length) within buffer_length
+bool read_data(Component& unit, const uint8_t reg, uint8_t* dst, const uint32_t len, const uint32_t sample_length,
+               const uint32_t buffer_length, uint32_t& wire_bytes);
+
+// Set and clear the bits of the register, and the others are kept
+bool modify_register8(Component& unit, const uint8_t reg, const uint8_t set, const uint8_t clear);
+
+// Index and time of the samples read from the FIFO
+struct Timeline {
+    // Clock (us) of the timeline and the adaptive polling
+    uint32_t now() const;
+    // Restart from the index 0
+    void restart(const uint32_t period);
+    /*
+      Stamp the batch of count samples read now
+      The samples lost are before the batch if the FIFO rolls over (MAX30102), otherwise (MAX30100) the new samples
+      are lost while the FIFO is full, so they are after the batch, and the gap of the next batch
+     */
+    void stamp(const uint_fast8_t count, const uint8_t overflow, const uint8_t depth, const bool rollover);
+    // The batch of count samples and those produced since the stamp are discarded, and become the next gap
+    void discard(const uint_fast8_t count);
+
+    uint32_t timestamp{}, sample_period{}, gap{}, sample_index{};
+    uint32_t next_index{}, read_at{}, read_elapsed{}, pending_gap{};
+    // Clock function instead of m5::utility::micros() if set (e.g. the virtual time of the host-side tests)
+    uint32_t (*micros)(void* arg){};
+    void* micros_arg{};
+};
+
+// Interrupt mode
+struct InterruptMode {
+    // Notified, or the INT pin is asserted
+    inline bool asserted() const
+    {
+        return notified || (data_ready && data_ready(data_ready_arg));
+    }
+    inline void enable(data_ready_function_t func, void* arg)
+    {
+        enabled        = true;
+        data_ready     = func;
+        data_ready_arg = arg;
+    }
+    inline void disable()
+    {
+        enabled        = false;
+        data_ready     = nullptr;
+        data_ready_arg = nullptr;
+    }
+
+    bool enabled{};
+    volatile bool notified{};
+    data_ready_function_t data_ready{};
+    void* data_ready_arg{};
+};
+
+// Split-phase asynchronous read
+struct AsyncRead {
+    bool enable(async_read_function_t f, void* a);
+    inline void disable()
+    {
+        func = nullptr;
+        arg  = nullptr;
+    }
+    // Start the transfer of len bytes (samples) of reg into dst
+    bool start(const uint8_t reg, uint8_t* dst, const uint32_t len, const uint8_t samples, uint32_t& wire_bytes);
+    // True if the transfer is completed successfully, the transfer ends if completed or failed
+    bool take();
+    // End the transfer without the completion, and return the samples of it
+    uint8_t cancel();
+
+    async_read_function_t func{};
+    void* arg{};
+    bool transferring{};
+    volatile int8_t result{};  // 0:In progress 1:Completed -1:Failed
+    uint8_t count{};
+};
+
+// Adaptive polling
+struct AdaptivePolling {
+    bool enable(const uint8_t level, const uint8_t depth);
+    // Next polling interval by the read retrieved and overflowed samples at elapsed (us) since the previous read
+    uint32_t next(const uint32_t interval, const uint32_t elapsed, const uint8_t retrieved,
+                  const uint8_t overflow) const;
+
+    bool enabled{};
+    uint8_t target{};
+    types::elapsed_time_t min_interval{}, max_interval{};
+};
+
+}  // namespace fifo
+///@endcond
+}  // namespace unit
+}  // namespace m5
+#endif
@@ -10,6 +10,7 @@
 #include "unit_MAX30100.hpp"
 #include <M5Utility.hpp>
 #include <limits>  // NaN
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 
@@ -22,15 +23,16 @@ namespace {
 constexpr uint8_t partId{0x11};
 constexpr uint32_t MEASURE_TEMPERATURE_DURATION{29};  // 29ms
 
+// Default of config_t::read_buffer_length
 #if defined(ARDUINO)
 #if defined(I2C_BUFFER_LENGTH)
-constexpr uint32_t read_buffer_length{I2C_BUFFER_LENGTH};
+constexpr uint32_t default_read_buffer_length{I2C_BUFFER_LENGTH};
 #else
-constexpr uint32_t read_buffer_length{32};
+constexpr uint32_t default_read_buffer_length{32};
 #endif
 #else
-//! @TODO for M5HAL
-constexpr uint32_t read_buffer_length{32};
+// M5HAL does not tell the buffer length, so configure config_t::read_buffer_length for the bus
+constexpr uint32_t default_read_buffer_length{32};
 #endif
 
 constexpr uint32_t sr_table[] = {50, 100, 167, 200, 400, 600, 800, 1000};
@@ -61,6 +63,19 @@ inline uint32_t calculate_interval_time(const Sampling rate)
     return std::floor(1000.f / sr_table[m5::stl::to_underlying(rate)]);
 }
 
+// Calculate the time until the FIFO holds the level samples (at least 1ms)
+inline uint32_t calculate_fill_time(const Sampling rate, const uint8_t level)
+{
+    uint32_t t = level * 1000U / sr_table[m5::stl::to_underlying(rate)];
+    return t ? t : 1;
+}
+
+// Calculate the period of the samples (us)
+inline uint32_t calculate_sample_period(const Sampling rate)
+{
+    return 1000000U / sr_table[m5::stl::to_underlying(rate)];
+}
+
 }  // namespace
 
 namespace m5 {
@@ -173,6 +188,10 @@ bool UnitMAX30100::begin()
         }
     }
 
+    // Beyond the whole FIFO is not needed
+    _read_buffer_length = std::min<uint32_t>(
+        _cfg.read_buffer_length ? _cfg.read_buffer_length : default_read_buffer_length, MAX_FIFO_DEPTH * 4);
+
     // Check PartID
     uint8_t pid{};
     if (!read_register8(READ_PART_ID, pid) || pid != partId) {
@@ -194,16 +213,64 @@ void UnitMAX30100::update(const bool force)
 {
     _updated = false;
     if (inPeriodic()) {
-        auto at = m5::utility::millis();
-        if (force || !_latest || at >= _latest + _interval) {
+        // The data ready function is not called while transferring (the INT pin stays asserted until the read)
+        if (_async.transferring) {
+            poll();
+            return;
+        }
+        auto at          = m5::utility::millis();
+        const bool ready = _interrupt.enabled ? _interrupt.asserted() : (!_latest || at >= _latest + _interval);
+        if (force || ready) {
+            _interrupt.notified = false;
+            if (_async.func) {
+                // Returns while transferring, poll() publishes after the completion
+                if (start_async_read()) {
+                    poll();
+                }
+                return;
+            }
             _updated = read_FIFO();
             if (_updated) {
-                _latest = m5::utility::millis();
+                retrieved_FIFO();
             }
         }
     }
 }
 
+bool UnitMAX30100::poll()
+{
+    if (!_async.take()) {
+        return false;
+    }
+    decode_FIFO(_async.count);
+    _updated = (_retrieved != 0);
+    if (_updated) {
+        retrieved_FIFO();
+    }
+    return _updated;
+}
+
+bool UnitMAX30100::cancelAsyncRead()
+{
+    if (!_async.transferring) {
+        return false;
+    }
+    // The samples of the transfer and those produced since reading the pointers are discarded by resetting the FIFO,
+    // and become the gap of the next read instead of the transfer
+    _timeline.discard(_async.cancel());
+    // A_FULL asserted during the transfer makes the empty FIFO look full, so clear it too
+    uint8_t status{};
+    return resetFIFO() && (!_interrupt.enabled || readInterruptStatus(status));
+}
+
+void UnitMAX30100::retrieved_FIFO()
+{
+    _latest = m5::utility::millis();
+    if (_adaptive.enabled && !_interrupt.enabled) {
+        _interval = _adaptive.next(_interval, _timeline.read_elapsed, _retrieved, _overflow);
+    }
+}
+
 bool UnitMAX30100::start_periodic_measurement()
 {
     if (inPeriodic()) {
@@ -212,10 +279,19 @@ bool UnitMAX30100::start_periodic_measurement()
 
     Sampling rate{};
     if (readSpO2SamplingRate(rate)) {
-        _periodic = writeShutdownControl(false) && resetFIFO();
+        _periodic = (!_interrupt.enabled ||
+                     fifo::modify_register8(*this, INTERRUPT_ENABLE, fifo::INT_A_FULL, 0x00)) &&
+                    writeShutdownControl(false) && resetFIFO();
         if (_periodic) {
-            _latest   = 0;
-            _interval = calculate_interval_time(rate);
+            _interrupt.notified    = false;
+            _latest                = 0;
+            _adaptive.min_interval = calculate_interval_time(rate);
+            _adaptive.max_interval = calculate_fill_time(rate, MAX_FIFO_DEPTH - 1);
+            _timeline.restart(calculate_sample_period(rate));
+            // The adaptive polling starts from the estimated time to reach the target
+            _interval = _adaptive.enabled
+                            ? std::min<uint32_t>(calculate_fill_time(rate, _adaptive.target), _adaptive.max_interval)
+                            : _adaptive.min_interval;
             // M5_LIB_LOGE(">>>>R: Rate:%u IT:%u", rate, _interval);
             //              _mask     = adc_resolution_bits_table[m5::stl::to_underlying(width)];
             return true;
@@ -237,6 +313,10 @@ bool UnitMAX30100::start_periodic_measurement(const max30100::Mode mode, const m
 
 bool UnitMAX30100::stop_periodic_measurement()
 {
+    if (_async.transferring) {
+        M5_LIB_LOGD("Transferring");
+        return false;
+    }
     ModeConfiguration mc{};
     if (read_register8(MODE_CONFIGURATION, mc.value)) {
         mc.shdn(true);
@@ -400,6 +480,68 @@ bool UnitMAX30100::resetFIFO()
            writeRegister8(FIFO_READ_POINTER, 0);
 }
 
+bool UnitMAX30100::enableInterruptMode(data_ready_function_t func, void* arg)
+{
+    if (inPeriodic()) {
+        M5_LIB_LOGD("Periodic measurements are running");
+        return false;
+    }
+    _interrupt.enable(func, arg);
+    return true;
+}
+
+bool UnitMAX30100::disableInterruptMode()
+{
+    if (inPeriodic()) {
+        M5_LIB_LOGD("Periodic measurements are running");
+        return false;
+    }
+    // Revert only the A_FULL enabled by the interrupt mode
+    if (_interrupt.enabled && !fifo::modify_register8(*this, INTERRUPT_ENABLE, 0x00, fifo::INT_A_FULL)) {
+        return false;
+    }
+    _interrupt.disable();
+    return true;
+}
+
+bool UnitMAX30100::enableAsyncRead(async_read_function_t func, void* arg)
+{
+    if (inPeriodic()) {
+        M5_LIB_LOGD("Periodic measurements are running");
+        return false;
+    }
+    return _async.enable(func, arg);
+}
+
+bool UnitMAX30100::disableAsyncRead()
+{
+    if (inPeriodic()) {
+        M5_LIB_LOGD("Periodic measurements are running");
+        return false;
+    }
+    _async.disable();
+    return true;
+}
+
+bool UnitMAX30100::enableAdaptivePolling(const uint8_t target)
+{
+    return _adaptive.enable(target, MAX_FIFO_DEPTH);
+}
+
+void UnitMAX30100::disableAdaptivePolling()
+{
+    _adaptive.enabled = false;
+    if (inPeriodic()) {
+        _interval = _adaptive.min_interval;
+    }
+}
+
+bool UnitMAX30100::readInterruptStatus(uint8_t& status)
+{
+    status = 0;
+    return read_register8(READ_INTERRUPT_STATUS, status);
+}
+
 bool UnitMAX30100::measureTemperatureSingleshot(TemperatureData& td)
 {
     ModeConfiguration mc{};
@@ -429,8 +571,9 @@ bool UnitMAX30100::reset()
         auto timeout_at = m5::utility::millis() + 1000;
         do {
             if (read_register8(MODE_CONFIGURATION, mc.value) && !mc.reset()) {
-                _periodic  = false;
-                _mode      = mc.mode();
+                _periodic           = false;
+                _mode               = mc.mode();
+                _interrupt.notified = false;
                 _retrieved = _overflow = 0;
                 m5::utility::delay(10);  // Wait for registers to settle after POR
                 return true;
@@ -444,54 +587,54 @@ bool UnitMAX30100::reset()
 //
 bool UnitMAX30100::read_FIFO()
 {
-    uint8_t wptr{}, rptr{};
-    _retrieved = _overflow = 0;
-
-    if (!read_register8(FIFO_WRITE_POINTER, wptr) || !read_register8(FIFO_READ_POINTER, rptr) ||
-        !read_register8(FIFO_OVERFLOW_COUNTER, _overflow)) {
-        M5_LIB_LOGE("Failed to read ptrs");
+    uint_fast8_t readCount{};
+    if (!read_FIFO_pointers(readCount)) {
         return false;
     }
-
-    uint_fast8_t readCount = _overflow        ? MAX_FIFO_DEPTH
-                             : (wptr >= rptr) ? (wptr - rptr)
-                                              : (wptr + MAX_FIFO_DEPTH - rptr);
-
-    // M5_LIB_LOGD("Ptr:%u/%u OF:%u RC:%u/%u", rptr, wptr, _overflow,
-    //             (wptr >= rptr) ? (wptr - rptr) : (wptr + MAX_FIFO_DEPTH - rptr), readCount);
-
-    assert(readCount <= MAX_FIFO_DEPTH);
-
     if (readCount) {
-        uint8_t reg{FIFO_DATA_REGISTER};
-        if (writeWithTransaction(&reg, 1) != m5::hal::error::error_t::OK) {
+        // Data is the raw 4 bytes as is, so read into the batch (retrievedData()) directly
+        static_assert(sizeof(Data) == 4, "Data must be 4 bytes");
+        if (!fifo::read_data(*this, FIFO_DATA_REGISTER, reinterpret_cast<uint8_t*>(_batch.data()), 4 * readCount, 4,
+                             _read_buffer_length, _wire_bytes)) {
             return false;
         }
-        uint8_t rbuf[MAX_FIFO_DEPTH * 4]{};
-
-        int32_t left = 4 * readCount;
-
-        while (left > 0) {
-            uint32_t batch_len   = (left > read_buffer_length) ? read_buffer_length - (read_buffer_length % 4) : left;
-            uint32_t batch_count = batch_len / 4;
+        decode_FIFO(readCount);
+    }
+    return (_retrieved != 0);
+}
 
-            // M5_LIB_LOGE("    batch:%u/%u", batch_len, batch_count);
+bool UnitMAX30100::read_FIFO_pointers(uint_fast8_t& readCount)
+{
+    _retrieved = _overflow = 0;
+    _wire_bytes            = 0;
+    // In the interrupt mode, the burst starts from the interrupt status (0x00 - 0x04) to clear it at the same time
+    if (!fifo::read_pointers(*this, READ_INTERRUPT_STATUS, FIFO_WRITE_POINTER, _interrupt.enabled, MAX_FIFO_DEPTH,
+                             readCount, _overflow, _wire_bytes)) {
+        M5_LIB_LOGE("Failed to read ptrs");
+        return false;
+    }
+    // Unlike MAX30102 (rollover), the new samples are lost while the FIFO is full
+    _timeline.stamp(readCount, _overflow, MAX_FIFO_DEPTH, false /* rollover */);
+    return true;
+}
 
-            if (readWithTransaction(rbuf, batch_len) != m5::hal::error::error_t::OK) {
-                return false;
-            }
+void UnitMAX30100::decode_FIFO(const uint_fast8_t readCount)
+{
+    for (uint_fast8_t i = 0; i < readCount; ++i) {
+        // Unlike MAX30102, the length of data per session does not change even in HROnly
+        _data->push_back(_batch[i]);
+    }
+    _retrieved = readCount;
+}
 
-            for (uint32_t i = 0; i < batch_count; ++i) {
-                Data d{};
-                // Unlike MAX30102, the length of data per session does not change even in HROnly
-                memcpy(d.raw.data(), rbuf + 4 * i, 4);
-                _data->push_back(d);
-            }
-            left -= batch_len;
-        }
-        _retrieved = readCount;
+bool UnitMAX30100::start_async_read()
+{
+    uint_fast8_t readCount{};
+    if (!read_FIFO_pointers(readCount) || !readCount) {
+        return false;
     }
-    return (_retrieved != 0);
+    return _async.start(FIFO_DATA_REGISTER, reinterpret_cast<uint8_t*>(_batch.data()), 4 * readCount, readCount,
+                        _wire_bytes);
 }
 
 bool UnitMAX30100::read_measurement_temperature(max30100::TemperatureData& td)
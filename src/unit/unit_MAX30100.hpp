@@ -10,10 +10,13 @@
 #ifndef M5_UNIT_HEART_UNIT_MAX30100_HPP
 #define M5_UNIT_HEART_UNIT_MAX30100_HPP
 
+#include "fifo_common.hpp"
+#include "../utility/span.hpp"
 #include <M5UnitComponent.hpp>
 #include <m5_utility/stl/extension.hpp>
 #include <m5_utility/container/circular_buffer.hpp>
 #include <limits>  // NaN
+#include <array>
 
 namespace m5 {
 namespace unit {
@@ -158,6 +161,8 @@ struct SpO2Configuration;
   @class m5::unit::UnitMAX30100
   @brief Pulse oximetry and heart-rate sensor
   @note The only single measurement is temperature; other data is constantly measured and stored
+  @note No heap allocation after begin(). The storage is allocated in the constructor and begin() (by stored_size),
+  and update() and the data accessors work within it
 */
 class UnitMAX30100 : public Component, public PeriodicMeasurementAdapter<UnitMAX30100, max30100::Data> {
     M5_UNIT_COMPONENT_HPP_BUILDER(UnitMAX30100, 0x57);
@@ -183,6 +188,12 @@ public:
         bool high_resolution{true};
         //! Led current for Red if start on begin (only SpO2)
         m5::unit::max30100::LED red_current{max30100::LED::Current27_1};
+        /*!
+          @brief Maximum bytes of a read transaction of the FIFO data (applied on begin)
+          @details 0 is the default of the platform (I2C_BUFFER_LENGTH of Arduino if defined, otherwise 32).
+          Set the buffer length of the bus to read the FIFO in fewer transactions (up to 64, the whole FIFO)
+         */
+        uint16_t read_buffer_length{0};
     };
 
     /*! @brief Constructor
@@ -256,6 +267,67 @@ public:
     {
         return _overflow;
     }
+    //! @brief Number of samples of the FIFO
+    static constexpr uint8_t fifoDepth()
+    {
+        return max30100::MAX_FIFO_DEPTH;
+    }
+    //! @brief Maximum bytes of a read transaction of the FIFO data
+    inline uint32_t readBufferLength() const
+    {
+        return _read_buffer_length;
+    }
+    /*!
+      @brief Bytes on the wire of the latest read
+      @details Address byte of each transaction, register address and data, of the pointers and the FIFO
+      @note wireBytes() / retrieved() is the bus cost per sample
+     */
+    inline uint32_t wireBytes() const
+    {
+        return _wire_bytes;
+    }
+    /*!
+      @brief Timestamp of the first data retrieved by the latest update (us, m5::utility::micros())
+      @details The newest data is at the read, so the data i of retrievedData() is at
+      timestamp() + i * samplePeriod()
+     */
+    inline uint32_t timestamp() const
+    {
+        return _timeline.timestamp;
+    }
+    //! @brief Period of the data (us) by the sampling rate and the averaging
+    inline uint32_t samplePeriod() const
+    {
+        return _timeline.sample_period;
+    }
+    /*!
+      @brief Number of samples lost just before the data retrieved by the latest update
+      @details overflow(), or estimated from the elapsed time since the previous read if the overflow counter is
+      saturated. Give it to the downstream (e.g. PulseMonitor::markGap()) to interpolate or reset
+      @note The new samples are lost while the FIFO is full, so overflow() of a read is the gap of the next read
+     */
+    inline uint32_t gap() const
+    {
+        return _timeline.gap;
+    }
+    /*!
+      @brief Index of the first data retrieved by the latest update
+      @details Samples since the start of the periodic measurement, including the lost samples
+     */
+    inline uint32_t sampleIndex() const
+    {
+        return _timeline.sample_index;
+    }
+    /*!
+      @brief Data retrieved by the latest update
+      @return Contiguous view of retrieved() data (oldest first)
+      @note The view is valid until the next update
+      @note The data are also stored as usual, use flush() after consuming them in bulk
+     */
+    inline m5::heart::Span<const max30100::Data> retrievedData() const
+    {
+        return m5::heart::Span<const max30100::Data>(_batch.data(), _retrieved);
+    }
     ///@}
 
     /*!
@@ -278,6 +350,7 @@ public:
     /*!
       @brief Start periodic measurement in the current settings
       @return True if successful
+      @note The interrupt enables are left alone, except A_FULL added in the interrupt mode
     */
     inline bool startPeriodicMeasurement()
     {
@@ -293,6 +366,7 @@ public:
       @param red_current RED Led control (only SpO2)
       @return True if successful
       @warning Note that some combinations of rate and width are invalid. See also datasheet
+      @note The interrupt enables are left alone, except A_FULL added in the interrupt mode
     */
     inline bool startPeriodicMeasurement(const max30100::Mode mode, const max30100::Sampling rate,
                                          const max30100::LEDPulse width, const max30100::LED ir_current,
@@ -497,6 +571,149 @@ public:
     bool resetFIFO();
     ///@}
 
+    ///@name Interrupt mode
+    ///@{
+    /*!
+      @brief Data ready function
+      @param arg Argument given to enableInterruptMode
+      @return True if the INT pin is asserted (e.g. digitalRead(pin) == LOW)
+     */
+    using data_ready_function_t = fifo::data_ready_function_t;
+    /*!
+      @brief Enable the interrupt mode
+      @details update() reads the FIFO only when the INT pin is asserted instead of every sampling interval.
+      The FIFO almost full (A_FULL) interrupt is enabled, so that one read drains (MAX_FIFO_DEPTH - 1) samples
+      @param func Function that tells the INT pin state (nullptr: notified by notifyInterrupt())
+      @param arg Argument for func
+      @return True if successful
+      @warning During periodic detection runs, an error is returned
+      @note Applied at the start of periodic measurement, A_FULL is added to the interrupt enables and the others are
+      kept
+     */
+    bool enableInterruptMode(data_ready_function_t func = nullptr, void* arg = nullptr);
+    /*!
+      @brief Disable the interrupt mode (update() polls by the sampling interval)
+      @return True if successful
+      @warning During periodic detection runs, an error is returned
+      @note Only A_FULL is removed from the interrupt enables
+     */
+    bool disableInterruptMode();
+    //! @brief Is the interrupt mode enabled?
+    inline bool inInterruptMode() const
+    {
+        return _interrupt.enabled;
+    }
+    /*!
+      @brief Notify that the INT pin is asserted
+      @note Can be called from the ISR of the INT pin (falling edge)
+     */
+    inline void notifyInterrupt()
+    {
+        _interrupt.notified = true;
+    }
+    /*!
+      @brief Read the interrupt status
+      @param[out] status Interrupt status (A_FULL, TEMP_RDY, HR_RDY, SPO2_RDY, PWR_RDY)
+      @return True if successful
+      @note Reading clears the status and deasserts the INT pin
+     */
+    bool readInterruptStatus(uint8_t& status);
+    ///@}
+
+    ///@name Asynchronous read
+    ///@{
+    /*!
+      @brief Asynchronous read function
+      @details Start reading len bytes of the register reg into dst (the register address without STOP, and the data
+      with the repeated START), and return without waiting for the transfer (e.g. the I2C driver with DMA, or the task
+      on the other core). Call completeAsyncRead() when the transfer is completed
+      @param reg Register address
+      @param dst Destination, must not be touched after the completion
+      @param len Number of bytes
+      @param arg Argument given to enableAsyncRead
+      @return True if the transfer is started
+     */
+    using async_read_function_t = fifo::async_read_function_t;
+    /*!
+      @brief Enable the asynchronous read
+      @details update() reads the FIFO pointers, starts the transfer of the FIFO data by func and returns,
+      and poll() (or update() while transferring) decodes and publishes the samples after the completion.
+      The caller can render or read the other units on the other buses during the transfer
+      @param func Function that starts the transfer
+      @param arg Argument for func
+      @return True if successful
+      @warning During periodic detection runs, an error is returned
+      @note retrievedData() is empty while transferring
+     */
+    bool enableAsyncRead(async_read_function_t func, void* arg = nullptr);
+    /*!
+      @brief Disable the asynchronous read (update() reads the FIFO until the end)
+      @return True if successful
+      @warning During periodic detection runs, an error is returned
+     */
+    bool disableAsyncRead();
+    //! @brief Is the asynchronous read enabled?
+    inline bool inAsyncRead() const
+    {
+        return _async.func != nullptr;
+    }
+    //! @brief Is the transfer in progress?
+    inline bool transferring() const
+    {
+        return _async.transferring;
+    }
+    /*!
+      @brief Notify the completion of the transfer
+      @param ok False if the transfer failed
+      @note Can be called from the completion callback of the driver (ISR)
+     */
+    inline void completeAsyncRead(const bool ok = true)
+    {
+        _async.result = ok ? 1 : -1;
+    }
+    /*!
+      @brief Decode and publish the samples if the transfer is completed
+      @return True if published (updated() is true)
+     */
+    bool poll();
+    /*!
+      @brief Abandon the transfer in progress
+      @details For the transfer that does not complete (e.g. the driver timed out or the bus is stuck).
+      Resets the FIFO, the samples of the transfer and those stored in the FIFO are lost and counted in the gap()
+      of the next read
+      @return True if the FIFO is reset
+      @warning Stop the transfer of the driver before calling it, the destination is reused by the next read
+      @note The completion notified after the call is ignored
+     */
+    bool cancelAsyncRead();
+    ///@}
+
+    ///@name Adaptive polling
+    ///@{
+    /*!
+      @brief Enable the adaptive polling
+      @details update() widens or narrows the polling interval by retrieved() and overflow() of each read and the
+      measured time since the previous read, so that each read retrieves about target samples. Fewer reads amortize
+      the cost of reading the pointers. A caller slower than the interval does not narrow it
+      @param target Target FIFO level (1 - MAX_FIFO_DEPTH - 1)
+      @return True if successful
+      @note Ignored in the interrupt mode
+     */
+    bool enableAdaptivePolling(const uint8_t target = max30100::MAX_FIFO_DEPTH * 3 / 4);
+    //! @brief Disable the adaptive polling (update() polls by the sampling interval)
+    void disableAdaptivePolling();
+    //! @brief Is the adaptive polling enabled?
+    inline bool inAdaptivePolling() const
+    {
+        return _adaptive.enabled;
+    }
+    //! @brief Target FIFO level of the adaptive polling
+    inline uint8_t adaptivePollingTarget() const
+    {
+        return _adaptive.target;
+    }
+    ///@}
+
     /*!
       @brief Reset
       @return True if successful
@@ -524,6 +741,10 @@ protected:
     bool stop_periodic_measurement();
 
     bool read_FIFO();
+    bool read_FIFO_pointers(uint_fast8_t& readCount);
+    void decode_FIFO(const uint_fast8_t readCount);
+    bool start_async_read();
+    void retrieved_FIFO();
     bool read_measurement_temperature(max30100::TemperatureData& td);
 
     bool write_spo2_configuration(const max30100::SpO2Configuration& sc);
@@ -533,9 +754,17 @@ protected:
 protected:
     max30100::Mode _mode{max30100::Mode::None};
     uint8_t _retrieved{}, _overflow{};
+    uint32_t _wire_bytes{};
+    uint32_t _read_buffer_length{};
+    fifo::Timeline _timeline{};  // Timeline of the latest read
     std::unique_ptr<m5::container::CircularBuffer<max30100::Data>> _data{};
+    std::array<max30100::Data, max30100::MAX_FIFO_DEPTH> _batch{};  // Data retrieved by the latest read
 
     config_t _cfg{};
+
+    fifo::InterruptMode _interrupt{};
+    fifo::AsyncRead _async{};
+    fifo::AdaptivePolling _adaptive{};
 };
 
 }  // namespace unit
@@ -23,15 +23,16 @@ namespace {
 constexpr uint8_t partId{0x15};
 constexpr uint32_t MEASURE_TEMPERATURE_DURATION{29};  // 29ms
 
+// Default of config_t::read_buffer_length
 #if defined(ARDUINO)
 #if defined(I2C_BUFFER_LENGTH)
-constexpr uint32_t read_buffer_length{I2C_BUFFER_LENGTH};
+constexpr uint32_t default_read_buffer_length{I2C_BUFFER_LENGTH};
 #else
-constexpr uint32_t read_buffer_length{32};
+constexpr uint32_t default_read_buffer_length{32};
 #endif
 #else
-//! @TODO for M5HAL
-constexpr uint32_t read_buffer_length{32};
+// M5HAL does not tell the buffer length, so configure config_t::read_buffer_length for the bus
+constexpr uint32_t default_read_buffer_length{32};
 #endif
 
 constexpr FIFOSampling fifo_sampling_table[] = {
@@ -167,6 +168,20 @@ inline uint32_t calculate_interval_time(const FIFOSampling avg, const Sampling r
     return interval ? interval : 1;
 }
 
+// Calculate the time until the FIFO holds the level samples (at least 1ms)
+inline uint32_t calculate_fill_time(const FIFOSampling avg, const Sampling rate, const uint8_t level)
+{
+    uint32_t t = level * 1000U * average_table[m5::stl::to_underlying(avg)] /
+                 sampling_rate_table[m5::stl::to_underlying(rate)];
+    return t ? t : 1;
+}
+
+// Calculate the period of the samples (us)
+inline uint32_t calculate_sample_period(const FIFOSampling avg, const Sampling rate)
+{
+    return 1000000U * average_table[m5::stl::to_underlying(avg)] / sampling_rate_table[m5::stl::to_underlying(rate)];
+}
+
 }  // namespace
 
 namespace m5 {
@@ -243,13 +258,29 @@ bool UnitMAX30102::begin()
 {
     auto ssize = stored_size();
     assert(ssize >= max30102::MAX_FIFO_DEPTH && "stored_size must be greater than MAX_FIFO_DEPTH");
-    if (ssize != _data->capacity()) {
-        _data.reset(new m5::container::CircularBuffer<Data>(ssize));
+    // Storage::Decoded stores the data in the decoded rings instead of the buffer of Data
+    const bool dec  = (_cfg.storage == Storage::Decoded);
+    const auto dcap = dec ? 1 : ssize;
+    if (dcap != _data->capacity()) {
+        _data.reset(new m5::container::CircularBuffer<Data>(dcap));
         if (!_data) {
             M5_LIB_LOGE("Failed to allocate");
             return false;
         }
     }
+    if (dec != decoded() || (dec && ssize != _decoded_capacity)) {
+        _decoded.reset(dec ? new uint32_t[ssize * 2] : nullptr);
+        if (dec && !_decoded) {
+            M5_LIB_LOGE("Failed to allocate");
+            return false;
+        }
+        _decoded_capacity = dec ? ssize : 0;
+    }
+    _decoded_head = _decoded_size = 0;
+
+    // Beyond the whole FIFO is not needed
+    _read_buffer_length = std::min<uint32_t>(
+        _cfg.read_buffer_length ? _cfg.read_buffer_length : default_read_buffer_length, MAX_FIFO_DEPTH * 6);
 
     // Check PartID
     uint8_t pid{};
@@ -278,16 +309,64 @@ void UnitMAX30102::update(const bool force)
 {
     _updated = false;
     if (inPeriodic()) {
-        auto at = m5::utility::millis();
-        if (force || !_latest || at >= _latest + _interval) {
+        // The data ready function is not called while transferring (the INT pin stays asserted until the read)
+        if (_async.transferring) {
+            poll();
+            return;
+        }
+        auto at          = m5::utility::millis();
+        const bool ready = _interrupt.enabled ? _interrupt.asserted() : (!_latest || at >= _latest + _interval);
+        if (force || ready) {
+            _interrupt.notified = false;
+            if (_async.func) {
+                // Returns while transferring, poll() publishes after the completion
+                if (start_async_read()) {
+                    poll();
+                }
+                return;
+            }
             _updated = (read_FIFO() && _retrieved);
             if (_updated) {
-                _latest = m5::utility::millis();
+                retrieved_FIFO();
             }
         }
     }
 }
 
+bool UnitMAX30102::poll()
+{
+    if (!_async.take()) {
+        return false;
+    }
+    decode_FIFO(_async.count);
+    _updated = (_retrieved != 0);
+    if (_updated) {
+        retrieved_FIFO();
+    }
+    return _updated;
+}
+
+bool UnitMAX30102::cancelAsyncRead()
+{
+    if (!_async.transferring) {
+        return false;
+    }
+    // The samples of the transfer and those produced since reading the pointers are discarded by resetting the FIFO,
+    // and become the gap of the next read instead of the transfer
+    _timeline.discard(_async.cancel());
+    // A_FULL asserted during the transfer makes the empty FIFO look full, so clear it too
+    uint8_t s1{}, s2{};
+    return resetFIFO() && (!_interrupt.enabled || readInterruptStatus(s1, s2));
+}
+
+void UnitMAX30102::retrieved_FIFO()
+{
+    _latest = m5::utility::millis();
+    if (_adaptive.enabled && !_interrupt.enabled) {
+        _interval = _adaptive.next(_interval, _timeline.read_elapsed, _retrieved, _overflow);
+    }
+}
+
 bool UnitMAX30102::start_periodic_measurement()
 {
     if (inPeriodic()) {
@@ -302,11 +381,21 @@ bool UnitMAX30102::start_periodic_measurement()
     LEDPulse width{};
 
     if (readFIFOConfiguration(avg, rollover, almostFull) && readSpO2Configuration(range, rate, width)) {
-        _periodic = writeFIFOConfiguration(avg, true /* rollover always true */, almostFull) &&
+        _periodic = writeFIFOConfiguration(avg, true /* rollover always true */,
+                                           _interrupt.enabled ? _almost_full : almostFull) &&
+                    (!_interrupt.enabled ||
+                     fifo::modify_register8(*this, INTERRUPT_ENABLE_1, fifo::INT_A_FULL, 0x00)) &&
                     writeShutdownControl(false) && resetFIFO();
         if (_periodic) {
-            _latest   = 0;
-            _interval = calculate_interval_time(avg, rate);
+            _interrupt.notified    = false;
+            _latest                = 0;
+            _adaptive.min_interval = calculate_interval_time(avg, rate);
+            _adaptive.max_interval = calculate_fill_time(avg, rate, MAX_FIFO_DEPTH - 1);
+            _timeline.restart(calculate_sample_period(avg, rate));
+            // The adaptive polling starts from the estimated time to reach the target
+            _interval = _adaptive.enabled ? std::min<uint32_t>(calculate_fill_time(avg, rate, _adaptive.target),
+                                                               _adaptive.max_interval)
+                                          : _adaptive.min_interval;
         }
     }
     return _periodic;
@@ -326,6 +415,10 @@ bool UnitMAX30102::start_periodic_measurement(const max30102::Mode mode, const m
 
 bool UnitMAX30102::stop_periodic_measurement()
 {
+    if (_async.transferring) {
+        M5_LIB_LOGD("Transferring");
+        return false;
+    }
     ModeConfiguration mc{};
     if (read_register8(MODE_CONFIGURATION, mc.value)) {
         mc.shdn(true);
@@ -601,6 +694,79 @@ bool UnitMAX30102::write_fifo_sampling_average(const max30102::FIFOSampling avg)
     return false;
 }
 
+bool UnitMAX30102::enableInterruptMode(data_ready_function_t func, void* arg, const uint8_t almostFull)
+{
+    if (inPeriodic()) {
+        M5_LIB_LOGD("Periodic measurements are running");
+        return false;
+    }
+    if (almostFull > 0x0F) {
+        M5_LIB_LOGE("Valid range 0 - 15 %u", almostFull);
+        return false;
+    }
+    _almost_full = almostFull;
+    _interrupt.enable(func, arg);
+    return true;
+}
+
+bool UnitMAX30102::disableInterruptMode()
+{
+    if (inPeriodic()) {
+        M5_LIB_LOGD("Periodic measurements are running");
+        return false;
+    }
+    // Revert only the A_FULL enabled by the interrupt mode
+    if (_interrupt.enabled && !fifo::modify_register8(*this, INTERRUPT_ENABLE_1, 0x00, fifo::INT_A_FULL)) {
+        return false;
+    }
+    _interrupt.disable();
+    return true;
+}
+
+bool UnitMAX30102::enableAsyncRead(async_read_function_t func, void* arg)
+{
+    if (inPeriodic()) {
+        M5_LIB_LOGD("Periodic measurements are running");
+        return false;
+    }
+    return _async.enable(func, arg);
+}
+
+bool UnitMAX30102::disableAsyncRead()
+{
+    if (inPeriodic()) {
+        M5_LIB_LOGD("Periodic measurements are running");
+        return false;
+    }
+    _async.disable();
+    return true;
+}
+
+bool UnitMAX30102::enableAdaptivePolling(const uint8_t target)
+{
+    return _adaptive.enable(target, MAX_FIFO_DEPTH);
+}
+
+void UnitMAX30102::disableAdaptivePolling()
+{
+    _adaptive.enabled = false;
+    if (inPeriodic()) {
+        _interval = _adaptive.min_interval;
+    }
+}
+
+bool UnitMAX30102::readInterruptStatus(uint8_t& status1, uint8_t& status2)
+{
+    status1 = status2 = 0;
+    uint8_t rbuf[2]{};
+    if (read_register(READ_INTERRUPT_STATUS_1, rbuf, 2)) {
+        status1 = rbuf[0];
+        status2 = rbuf[1];
+        return true;
+    }
+    return false;
+}
+
 bool UnitMAX30102::reset_FIFO(const bool circling_read_ptr)
 {
     if (!writeFIFOReadPointer(0) || !writeFIFOWritePointer(0) || !writeFIFOOverflowCounter(0)) {
@@ -621,76 +787,156 @@ bool UnitMAX30102::reset_FIFO(const bool circling_read_ptr)
 
 bool UnitMAX30102::read_FIFO()
 {
-    uint8_t rptr{}, wptr{};
-    _retrieved = _overflow = 0;
+    uint_fast8_t readCount{};
+    if (!read_FIFO_pointers(readCount)) {
+        return false;
+    }
+    const uint32_t dlen = sample_length();
+    if (dlen && readCount) {
+        if (!fifo::read_data(*this, FIFO_DATA_REGISTER, FIFO_destination(readCount), dlen * readCount, dlen,
+                             _read_buffer_length, _wire_bytes)) {
+            return false;
+        }
+        decode_FIFO(readCount);
+    }
+    return (_retrieved != 0);
+}
 
-    if (!readFIFOReadPointer(rptr) || !readFIFOWritePointer(wptr) || !readFIFOOverflowCounter(_overflow)) {
+bool UnitMAX30102::read_FIFO_pointers(uint_fast8_t& readCount)
+{
+    _retrieved = _overflow = 0;
+    _wire_bytes            = 0;
+    // In the interrupt mode, the burst starts from the interrupt status (0x00 - 0x06) to clear it at the same time
+    if (!fifo::read_pointers(*this, READ_INTERRUPT_STATUS_1, FIFO_WRITE_POINTER, _interrupt.enabled, MAX_FIFO_DEPTH,
+                             readCount, _overflow, _wire_bytes)) {
         M5_LIB_LOGE("Failed to read ptrs");
         return false;
     }
+    _timeline.stamp(readCount, _overflow, MAX_FIFO_DEPTH, true /* rollover */);
+    return true;
+}
 
-    uint_fast8_t readCount = _overflow        ? MAX_FIFO_DEPTH
-                             : (wptr >= rptr) ? (wptr - rptr)
-                                              : (wptr + MAX_FIFO_DEPTH - rptr);
-
-    // M5_LIB_LOGD("Ptr:%u/%u OF:%u RC:%u/%u", rptr, wptr, _overflow,
-    //             (wptr >= rptr) ? (wptr - rptr) : (wptr + MAX_FIFO_DEPTH - rptr), readCount);
+uint32_t UnitMAX30102::sample_length() const
+{
+    return (_mode == Mode::HROnly)     ? 3
+           : (_mode == Mode::SpO2)     ? 6
+           : (_mode == Mode::MultiLED) ? 3 * ((_slot[0] != Slot::None) + (_slot[1] != Slot::None))
+                                       : 0;
+}
 
-    assert(readCount <= MAX_FIFO_DEPTH);
+uint8_t* UnitMAX30102::FIFO_destination(const uint_fast8_t readCount)
+{
+    // Read into the tail of the batch and decode in place from the head, without the staging buffer
+    // Data is larger than the sample, so decoding a sample does not overwrite the bytes of the following samples
+    static_assert(sizeof(Data) >= 6, "Data must not be smaller than the sample");
+    return reinterpret_cast<uint8_t*>(_batch.data()) + sizeof(_batch) - sample_length() * readCount;
+}
 
-    uint32_t dlen = (_mode == Mode::HROnly)     ? 3
-                    : (_mode == Mode::SpO2)     ? 6
-                    : (_mode == Mode::MultiLED) ? 3 * ((_slot[0] != Slot::None) + (_slot[1] != Slot::None))
-                                                : 0;
-    if (dlen && readCount) {
-        uint8_t reg{FIFO_DATA_REGISTER};
-        if (writeWithTransaction(&reg, 1) != m5::hal::error::error_t::OK) {
-            return false;
+void UnitMAX30102::decode_FIFO(const uint_fast8_t readCount)
+{
+    const uint32_t dlen = sample_length();
+    const uint8_t* src  = FIFO_destination(readCount);
+    for (uint_fast8_t i = 0; i < readCount; ++i) {
+        uint8_t sample[6]{};
+        memcpy(sample, src + dlen * i, dlen);
+        // Decode into the batch, which is retrievedData()
+        Data& d = _batch[i];
+        d       = Data{};
+        d.mask  = fifo_data_mask;
+        switch (_mode) {
+                // IR 3 bytes
+            case Mode::HROnly:
+                memcpy(d.raw.data() + 3, sample, dlen);
+                break;
+                // Data order depends slots setting 3 or 6 bytes
+            case Mode::MultiLED:
+                memcpy(d.raw.data() + 3 * (_slot[0] == Slot::IR), sample, 3);
+                if (dlen == 6) {
+                    memcpy(d.raw.data() + 3 * (_slot[1] == Slot::IR), sample + 3, 3);
+                }
+                break;
+                // SPO2 Red,IR 6 bytes
+            default:
+                memcpy(d.raw.data(), sample, dlen);
+                break;
         }
-        uint8_t rbuf[MAX_FIFO_DEPTH * 6]{};
-
-        // M5_LIB_LOGE("blen:%u dlen:%u rc:%u len:%u/%u", read_buffer_length, dlen, readCount, dlen * readCount,
-        //             MAX_FIFO_DEPTH * 6);
-
-        int32_t left = dlen * readCount;
+        if (decoded()) {
+            push_decoded(d.ir(), d.red());
+        } else {
+            _data->push_back(d);
+        }
+    }
+    _retrieved = readCount;
+}
 
-        while (left > 0) {
-            uint32_t batch_len = (left > read_buffer_length) ? read_buffer_length - (read_buffer_length % dlen) : left;
-            uint32_t batch_count = batch_len / dlen;
+bool UnitMAX30102::start_async_read()
+{
+    uint_fast8_t readCount{};
+    if (!read_FIFO_pointers(readCount)) {
+        return false;
+    }
+    const uint32_t dlen = sample_length();
+    if (!dlen || !readCount) {
+        return false;
+    }
+    return _async.start(FIFO_DATA_REGISTER, FIFO_destination(readCount), dlen * readCount, readCount, _wire_bytes);
+}
 
-            // M5_LIB_LOGE("    batch:%u/%u", batch_len, batch_count);
+void UnitMAX30102::push_decoded(const uint32_t ir, const uint32_t red)
+{
+    size_t tail = _decoded_head + _decoded_size;
+    tail -= (tail >= _decoded_capacity) ? _decoded_capacity : 0;
+    _decoded[tail]                     = ir;
+    _decoded[_decoded_capacity + tail] = red;
+    if (_decoded_size < _decoded_capacity) {
+        ++_decoded_size;
+    } else {
+        // Overwrite the oldest as CircularBuffer
+        _decoded_head = (_decoded_head + 1 < _decoded_capacity) ? _decoded_head + 1 : 0;
+    }
+}
 
-            if (readWithTransaction(rbuf, batch_len) != m5::hal::error::error_t::OK) {
-                return false;
-            }
+void UnitMAX30102::discard(const size_t n)
+{
+    if (decoded()) {
+        const size_t cnt = std::min(n, _decoded_size);
+        _decoded_head    = (_decoded_head + cnt) % _decoded_capacity;
+        _decoded_size -= cnt;
+        return;
+    }
+    for (size_t i = 0; i < n && !_data->empty(); ++i) {
+        _data->pop_front();
+    }
+}
 
-            for (uint32_t i = 0; i < batch_count; ++i) {
-                Data d;
-                d.mask = fifo_data_mask;
-                switch (_mode) {
-                        // IR 3 bytes
-                    case Mode::HROnly:
-                        memcpy(d.raw.data() + 3, rbuf + dlen * i, dlen);
-                        break;
-                        // Data order depends slots setting 3 or 6 bytes
-                    case Mode::MultiLED:
-                        memcpy(d.raw.data() + 3 * (_slot[0] == Slot::IR), rbuf + dlen * i, 3);
-                        if (dlen == 6) {
-                            memcpy(d.raw.data() + 3 * (_slot[1] == Slot::IR), rbuf + dlen * i + 3, 3);
-                        }
-                        break;
-                        // SPO2 Red,IR 6 bytes
-                    default:
-                        memcpy(d.raw.data(), rbuf + dlen * i, dlen);
-                        break;
-                }
-                _data->push_back(d);
-            }
-            left -= batch_len;
+max30102::Data UnitMAX30102::decoded_data(const size_t idx) const
+{
+    Data d{};
+    d.mask = fifo_data_mask;
+    if (idx < _decoded_size) {
+        size_t pos = _decoded_head + idx;
+        pos -= (pos >= _decoded_capacity) ? _decoded_capacity : 0;
+        const uint32_t ir  = _decoded[pos];
+        const uint32_t red = _decoded[_decoded_capacity + pos];
+        for (uint_fast8_t i = 0; i < 3; ++i) {
+            d.raw[i]     = static_cast<uint8_t>(red >> (16 - 8 * i));
+            d.raw[3 + i] = static_cast<uint8_t>(ir >> (16 - 8 * i));
         }
-        _retrieved = readCount;
     }
-    return (_retrieved != 0);
+    return d;
+}
+
+size_t UnitMAX30102::decoded_views(const uint32_t* top, m5::heart::Span<const uint32_t>& first,
+                                   m5::heart::Span<const uint32_t>& second) const
+{
+    first = second = m5::heart::Span<const uint32_t>();
+    if (!decoded()) {
+        return 0;
+    }
+    const size_t flen = std::min(_decoded_size, _decoded_capacity - _decoded_head);
+    first             = m5::heart::Span<const uint32_t>(top + _decoded_head, flen);
+    second            = m5::heart::Span<const uint32_t>(top, _decoded_size - flen);
+    return _decoded_size;
 }
 
 bool UnitMAX30102::reset()
@@ -701,8 +947,9 @@ bool UnitMAX30102::reset()
         auto timeout_at = m5::utility::millis() + 1000;
         do {
             if (read_register8(MODE_CONFIGURATION, mc.value) && !mc.reset()) {
-                _periodic  = false;
-                _mode      = mc.mode();
+                _periodic           = false;
+                _mode               = mc.mode();
+                _interrupt.notified = false;
                 _retrieved = _overflow = 0;
                 _slot[0] = _slot[1] = Slot::None;
                 m5::utility::delay(10);  // Wait for registers to settle after POR
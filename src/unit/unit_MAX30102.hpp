@@ -10,10 +10,13 @@
 #ifndef M5_UNIT_HEART_UNIT_MAX30102_HPP
 #define M5_UNIT_HEART_UNIT_MAX30102_HPP
 
+#include "fifo_common.hpp"
+#include "../utility/span.hpp"
 #include <M5UnitComponent.hpp>
 #include <m5_utility/stl/extension.hpp>
 #include <m5_utility/container/circular_buffer.hpp>
 #include <limits>  // NaN
+#include <array>
 
 namespace m5 {
 namespace unit {
@@ -99,6 +102,15 @@ enum class FIFOSampling : uint8_t {
     //    Average32, duplicated
 };
 
+/*!
+  @enum Storage
+  @brief How the periodic data is stored
+ */
+enum class Storage : uint8_t {
+    Raw,      //!< Data (raw FIFO bytes and mask) per sample
+    Decoded,  //!< Decoded IR and Red in separate contiguous arrays (8 bytes per sample instead of 12)
+};
+
 constexpr uint8_t MAX_FIFO_DEPTH{32};  //!< @brief FIFO depth
 
 /*!
@@ -186,6 +198,8 @@ struct SpO2Configuration;
   @class m5::unit::UnitMAX30102
   @brief Pulse oximetry and heart-rate sensor
   @note The only single measurement is temperature; other data is constantly measured and stored
+  @note No heap allocation after begin(). The storage is allocated in the constructor and begin() (by stored_size),
+  and update() and the data accessors work within it
 */
 class UnitMAX30102 : public Component, public PeriodicMeasurementAdapter<UnitMAX30102, max30102::Data> {
     M5_UNIT_COMPONENT_HPP_BUILDER(UnitMAX30102, 0x57);
@@ -217,6 +231,14 @@ public:
         uint8_t red_current{0x1F};
         //! FIFO sampling average if start on begin
         max30102::FIFOSampling fifo_sampling_average{max30102::FIFOSampling::Average4};
+        //! Storage of the periodic data (applied on begin)
+        max30102::Storage storage{max30102::Storage::Raw};
+        /*!
+          @brief Maximum bytes of a read transaction of the FIFO data (applied on begin)
+          @details 0 is the default of the platform (I2C_BUFFER_LENGTH of Arduino if defined, otherwise 32).
+          Set the buffer length of the bus to read the FIFO in fewer transactions (up to 192, the whole FIFO)
+         */
+        uint16_t read_buffer_length{0};
     };
 
     /*! @brief Constructor
@@ -257,12 +279,13 @@ public:
     //! @brief Oldest IR
     inline uint32_t ir() const
     {
-        return !empty() ? oldest().ir() : 0;
+        return decoded() ? (_decoded_size ? _decoded[_decoded_head] : 0) : (!empty() ? oldest().ir() : 0);
     }
     //! @brief Oldest Red
     inline uint32_t red() const
     {
-        return !empty() ? oldest().red() : 0;
+        return decoded() ? (_decoded_size ? _decoded[_decoded_capacity + _decoded_head] : 0)
+                         : (!empty() ? oldest().red() : 0);
     }
     /*!
       @brief Number of data last retrieved
@@ -289,6 +312,113 @@ public:
     {
         return _overflow;
     }
+    //! @brief Number of samples of the FIFO
+    static constexpr uint8_t fifoDepth()
+    {
+        return max30102::MAX_FIFO_DEPTH;
+    }
+    //! @brief Maximum bytes of a read transaction of the FIFO data
+    inline uint32_t readBufferLength() const
+    {
+        return _read_buffer_length;
+    }
+    /*!
+      @brief Bytes on the wire of the latest read
+      @details Address byte of each transaction, register address and data, of the pointers and the FIFO
+      @note wireBytes() / retrieved() is the bus cost per sample
+     */
+    inline uint32_t wireBytes() const
+    {
+        return _wire_bytes;
+    }
+    /*!
+      @brief Timestamp of the first data retrieved by the latest update (us, m5::utility::micros())
+      @details The newest data is at the read, so the data i of retrievedData() is at
+      timestamp() + i * samplePeriod()
+     */
+    inline uint32_t timestamp() const
+    {
+        return _timeline.timestamp;
+    }
+    //! @brief Period of the data (us) by the sampling rate and the averaging
+    inline uint32_t samplePeriod() const
+    {
+        return _timeline.sample_period;
+    }
+    /*!
+      @brief Number of samples lost just before the data retrieved by the latest update
+      @details overflow(), or estimated from the elapsed time since the previous read if the overflow counter is
+      saturated. Give it to the downstream (e.g. PulseMonitor::markGap()) to interpolate or reset
+     */
+    inline uint32_t gap() const
+    {
+        return _timeline.gap;
+    }
+    /*!
+      @brief Index of the first data retrieved by the latest update
+      @details Samples since the start of the periodic measurement, including the lost samples
+     */
+    inline uint32_t sampleIndex() const
+    {
+        return _timeline.sample_index;
+    }
+    /*!
+      @brief Data retrieved by the latest update
+      @return Contiguous view of retrieved() data (oldest first)
+      @note The view is valid until the next update
+      @note The data are also stored as usual, use flush() after consuming them in bulk
+     */
+    inline m5::heart::Span<const max30102::Data> retrievedData() const
+    {
+        return m5::heart::Span<const max30102::Data>(_batch.data(), _retrieved);
+    }
+    ///@}
+
+    ///@name Stored data
+    ///@{
+    using PeriodicMeasurementAdapter<UnitMAX30102, max30102::Data>::discard;
+    /*!
+      @brief Discard the oldest data in bulk
+      @param n Number of the data
+     */
+    void discard(const size_t n);
+    ///@}
+
+    ///@name Decoded storage
+    ///@{
+    /*!
+      @brief Is the data stored as Storage::Decoded?
+      @note available(), oldest(), discard() and so on of PeriodicMeasurementAdapter work with both storages.
+      In Storage::Decoded, oldest() and latest() encode Data from the decoded values on each call. Prefer ir() and red()
+     */
+    inline bool decoded() const
+    {
+        return _decoded_capacity != 0;
+    }
+    /*!
+      @brief Stored IR in Storage::Decoded
+      @param[out] first Older part
+      @param[out] second Newer part (empty unless the storage wraps around)
+      @return Number of the stored data (first.size() + second.size())
+      @note The views are valid until the next update or discard
+      @note Empty in Storage::Raw
+     */
+    inline size_t decodedIR(m5::heart::Span<const uint32_t>& first, m5::heart::Span<const uint32_t>& second) const
+    {
+        return decoded_views(_decoded.get(), first, second);
+    }
+    /*!
+      @brief Stored Red in Storage::Decoded
+      @param[out] first Older part
+      @param[out] second Newer part (empty unless the storage wraps around)
+      @return Number of the stored data (first.size() + second.size())
+      @note The views are valid until the next update or discard
+      @note Empty in Storage::Raw
+     */
+    inline size_t decodedRed(m5::heart::Span<const uint32_t>& first, m5::heart::Span<const uint32_t>& second) const
+    {
+        return decoded_views(_decoded.get() + _decoded_capacity, first, second);
+    }
     ///@}
 
     /*!
@@ -311,6 +441,7 @@ public:
     /*!
       @brief Start periodic measurement in the current settings
       @return True if successful
+      @note The interrupt enables are left alone, except A_FULL added in the interrupt mode
     */
     inline bool startPeriodicMeasurement()
     {
@@ -327,6 +458,7 @@ public:
       @param red_current RED Led control (for Mode::SPO2 and Mode::MultiLED)
       @return True if successful
       @warning Note that some combinations of rate and width are invalid. See also datasheet
+      @note The interrupt enables are left alone, except A_FULL added in the interrupt mode
     */
     inline bool startPeriodicMeasurement(const max30102::Mode mode, const max30102::ADC range,
                                          const max30102::Sampling rate, const max30102::LEDPulse width,
@@ -596,6 +728,151 @@ public:
     }
     ///@}
 
+    ///@name Interrupt mode
+    ///@{
+    /*!
+      @brief Data ready function
+      @param arg Argument given to enableInterruptMode
+      @return True if the INT pin is asserted (e.g. digitalRead(pin) == LOW)
+     */
+    using data_ready_function_t = fifo::data_ready_function_t;
+    /*!
+      @brief Enable the interrupt mode
+      @details update() reads the FIFO only when the INT pin is asserted instead of every sampling interval.
+      The FIFO almost full (A_FULL) interrupt is enabled, so that one read drains (MAX_FIFO_DEPTH - almostFull) samples
+      @param func Function that tells the INT pin state (nullptr: notified by notifyInterrupt())
+      @param arg Argument for func
+      @param almostFull Number of empty FIFO spaces when the interrupt asserts (0 - 15)
+      @return True if successful
+      @warning During periodic detection runs, an error is returned
+      @note Applied at the start of periodic measurement, A_FULL is added to the interrupt enables and the others are
+      kept
+     */
+    bool enableInterruptMode(data_ready_function_t func = nullptr, void* arg = nullptr, const uint8_t almostFull = 4);
+    /*!
+      @brief Disable the interrupt mode (update() polls by the sampling interval)
+      @return True if successful
+      @warning During periodic detection runs, an error is returned
+      @note Only A_FULL is removed from the interrupt enables
+     */
+    bool disableInterruptMode();
+    //! @brief Is the interrupt mode enabled?
+    inline bool inInterruptMode() const
+    {
+        return _interrupt.enabled;
+    }
+    /*!
+      @brief Notify that the INT pin is asserted
+      @note Can be called from the ISR of the INT pin (falling edge)
+     */
+    inline void notifyInterrupt()
+    {
+        _interrupt.notified = true;
+    }
+    /*!
+      @brief Read the interrupt status
+      @param[out] status1 Interrupt status 1 (A_FULL, PPG_RDY, ALC_OVF, PWR_RDY)
+      @param[out] status2 Interrupt status 2 (DIE_TEMP_RDY)
+      @return True if successful
+      @note Reading clears the status and deasserts the INT pin
+     */
+    bool readInterruptStatus(uint8_t& status1, uint8_t& status2);
+    ///@}
+
+    ///@name Asynchronous read
+    ///@{
+    /*!
+      @brief Asynchronous read function
+      @details Start reading len bytes of the register reg into dst (the register address without STOP, and the data
+      with the repeated START), and return without waiting for the transfer (e.g. the I2C driver with DMA, or the task
+      on the other core). Call completeAsyncRead() when the transfer is completed
+      @param reg Register address
+      @param dst Destination, must not be touched after the completion
+      @param len Number of bytes
+      @param arg Argument given to enableAsyncRead
+      @return True if the transfer is started
+     */
+    using async_read_function_t = fifo::async_read_function_t;
+    /*!
+      @brief Enable the asynchronous read
+      @details update() reads the FIFO pointers, starts the transfer of the FIFO data by func and returns,
+      and poll() (or update() while transferring) decodes and publishes the samples after the completion.
+      The caller can render or read the other units on the other buses during the transfer
+      @param func Function that starts the transfer
+      @param arg Argument for func
+      @return True if successful
+      @warning During periodic detection runs, an error is returned
+      @note retrievedData() is empty while transferring
+     */
+    bool enableAsyncRead(async_read_function_t func, void* arg = nullptr);
+    /*!
+      @brief Disable the asynchronous read (update() reads the FIFO until the end)
+      @return True if successful
+      @warning During periodic detection runs, an error is returned
+     */
+    bool disableAsyncRead();
+    //! @brief Is the asynchronous read enabled?
+    inline bool inAsyncRead() const
+    {
+        return _async.func != nullptr;
+    }
+    //! @brief Is the transfer in progress?
+    inline bool transferring() const
+    {
+        return _async.transferring;
+    }
+    /*!
+      @brief Notify the completion of the transfer
+      @param ok False if the transfer failed
+      @note Can be called from the completion callback of the driver (ISR)
+     */
+    inline void completeAsyncRead(const bool ok = true)
+    {
+        _async.result = ok ? 1 : -1;
+    }
+    /*!
+      @brief Decode and publish the samples if the transfer is completed
+      @return True if published (updated() is true)
+     */
+    bool poll();
+    /*!
+      @brief Abandon the transfer in progress
+      @details For the transfer that does not complete (e.g. the driver timed out or the bus is stuck).
+      Resets the FIFO, the samples of the transfer and those stored in the FIFO are lost and counted in the gap()
+      of the next read
+      @return True if the FIFO is reset
+      @warning Stop the transfer of the driver before calling it, the destination is reused by the next read
+      @note The completion notified after the call is ignored
+     */
+    bool cancelAsyncRead();
+    ///@}
+
+    ///@name Adaptive polling
+    ///@{
+    /*!
+      @brief Enable the adaptive polling
+      @details update() widens or narrows the polling interval by retrieved() and overflow() of each read and the
+      measured time since the previous read, so that each read retrieves about target samples. Fewer reads amortize
+      the cost of reading the pointers. A caller slower than the interval does not narrow it
+      @param target Target FIFO level (1 - MAX_FIFO_DEPTH - 1)
+      @return True if successful
+      @note Ignored in the interrupt mode
+     */
+    bool enableAdaptivePolling(const uint8_t target = max30102::MAX_FIFO_DEPTH * 3 / 4);
+    //! @brief Disable the adaptive polling (update() polls by the sampling interval)
+    void disableAdaptivePolling();
+    //! @brief Is the adaptive polling enabled?
+    inline bool inAdaptivePolling() const
+    {
+        return _adaptive.enabled;
+    }
+    //! @brief Target FIFO level of the adaptive polling
+    inline uint8_t adaptivePollingTarget() const
+    {
+        return _adaptive.target;
+    }
+    ///@}
+
     /*!
       @brief Reset
       @return True if successful
@@ -632,18 +909,75 @@ protected:
     bool write_fifo_sampling_average(const max30102::FIFOSampling avg);
 
     bool read_FIFO();
+    bool read_FIFO_pointers(uint_fast8_t& readCount);
+    uint32_t sample_length() const;
+    uint8_t* FIFO_destination(const uint_fast8_t readCount);
+    void decode_FIFO(const uint_fast8_t readCount);
+    bool start_async_read();
+    void retrieved_FIFO();
     bool reset_FIFO(const bool circling_read_ptr = true);
 
     bool read_measurement_temperature(max30102::TemperatureData& td);
 
-    M5_UNIT_COMPONENT_PERIODIC_MEASUREMENT_ADAPTER_HPP_BUILDER(UnitMAX30102, max30102::Data);
+    void push_decoded(const uint32_t ir, const uint32_t red);
+    max30102::Data decoded_data(const size_t idx) const;
+    size_t decoded_views(const uint32_t* top, m5::heart::Span<const uint32_t>& first,
+                         m5::heart::Span<const uint32_t>& second) const;
+
+    // Same as M5_UNIT_COMPONENT_PERIODIC_MEASUREMENT_ADAPTER_HPP_BUILDER, but also work with Storage::Decoded
+    friend class PeriodicMeasurementAdapter<UnitMAX30102, max30102::Data>;
+    inline max30102::Data oldest_periodic_data() const
+    {
+        return decoded() ? decoded_data(0) : (!_data->empty() ? _data->front().value() : max30102::Data{});
+    }
+    inline max30102::Data latest_periodic_data() const
+    {
+        return decoded() ? decoded_data(_decoded_size - 1)
+                         : (!_data->empty() ? _data->back().value() : max30102::Data{});
+    }
+    inline size_t available_periodic_measurement_data() const
+    {
+        return decoded() ? _decoded_size : _data->size();
+    }
+    inline bool empty_periodic_measurement_data() const
+    {
+        return decoded() ? !_decoded_size : _data->empty();
+    }
+    inline bool full_periodic_measurement_data() const
+    {
+        return decoded() ? _decoded_size == _decoded_capacity : _data->full();
+    }
+    inline void discard_periodic_measurement_data()
+    {
+        discard(1);
+    }
+    inline void flush_periodic_measurement_data()
+    {
+        if (decoded()) {
+            _decoded_head = _decoded_size = 0;
+            return;
+        }
+        _data->clear();
+    }
 
 protected:
     std::unique_ptr<m5::container::CircularBuffer<max30102::Data>> _data{};
+    std::array<max30102::Data, max30102::MAX_FIFO_DEPTH> _batch{};  // Data retrieved by the latest read
+    // Storage::Decoded: IR [0 ... capacity - 1] and Red [capacity ... capacity * 2 - 1] rings
+    std::unique_ptr<uint32_t[]> _decoded{};
+    size_t _decoded_capacity{}, _decoded_head{}, _decoded_size{};
     max30102::Mode _mode{};
     uint8_t _retrieved{}, _overflow{};
+    uint32_t _wire_bytes{};
+    uint32_t _read_buffer_length{};
+    fifo::Timeline _timeline{};  // Timeline of the latest read
     max30102::Slot _slot[2]{};
     config_t _cfg{};
+
+    fifo::InterruptMode _interrupt{};
+    uint8_t _almost_full{};
+    fifo::AsyncRead _async{};
+    fifo::AdaptivePolling _adaptive{};
 };
 
 }  // namespace unit
@@ -0,0 +1,251 @@
+/*
+ * SPDX-FileCopyrightText: 2026 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file acquisition_runner.hpp
+  @brief Drain the FIFO of the unit on the dedicated task
+  @note Not included by M5UnitUnifiedHEART.hpp, as it pulls in the task (FreeRTOS or std::thread).
+  Include "utility/acquisition_runner.hpp" to use it
+*/
+#ifndef M5_UNIT_HEART_UTILITY_ACQUISITION_RUNNER_HPP
+#define M5_UNIT_HEART_UTILITY_ACQUISITION_RUNNER_HPP
+
+#include "spsc_ring.hpp"
+#include <m5_utility/log/library_log.hpp>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#if defined(ESP_PLATFORM)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#else
+#include <thread>
+#include <chrono>
+#endif
+
+namespace m5 {
+namespace heart {
+
+/*!
+  @struct Sample
+  @brief Decoded sample of the unit
+ */
+struct Sample {
+    // Aggregate (no default member initializers) for Sample{ir, red, gap} in C++11, Sample{} zeroes all
+    uint32_t ir, red;
+    //! Number of samples lost just before this sample (FIFO overflow of the sensor and full ring)
+    uint32_t gap;
+};
+
+/*!
+  @class AcquisitionRunner
+  @brief Drain the FIFO of UnitMAX30102/UnitMAX30100 on the dedicated task at the fixed cadence
+  @details The task (FreeRTOS task pinned to the core on ESP32, std::thread on the others) calls update() of the unit
+  at the cadence and pushes the retrieved samples into the lock-free SPSC ring, and the application pops them at its
+  leisure. A slow frame of the application (e.g. EPD refresh) does not overflow the FIFO of the sensor, as long as
+  the ring has room
+  @tparam U Unit class (UnitMAX30102 or UnitMAX30100)
+  @tparam N Capacity of the ring (power of 2)
+  @warning The unit belongs to the task while running. Do not call any function of the unit, including update() by
+  UnitUnified::update(), until stop()
+ */
+template <class U, size_t N = 256>
+class AcquisitionRunner {
+public:
+    /*!
+      @struct config_t
+      @brief Settings of the task
+     */
+    struct config_t {
+        //! Cadence (ms), 0 is the time to fill the half of the FIFO
+        uint32_t interval{0};
+        //! Stack size of the task (FreeRTOS)
+        uint32_t stack_size{4096};
+        //! Priority of the task (FreeRTOS)
+        uint8_t priority{5};
+        //! Core of the task (FreeRTOS), -1 is no affinity
+        int8_t core{-1};
+    };
+
+    //! @brief Constructor
+    explicit AcquisitionRunner(U& unit) : _unit(unit)
+    {
+    }
+    ~AcquisitionRunner()
+    {
+        stop();
+    }
+
+    AcquisitionRunner(const AcquisitionRunner&)            = delete;
+    AcquisitionRunner& operator=(const AcquisitionRunner&) = delete;
+
+    /*!
+      @brief Start the task
+      @param cfg Settings
+      @return True if successful
+      @warning The periodic measurement of the unit must be running
+     */
+    bool start(const config_t& cfg = config_t{})
+    {
+        if (running()) {
+            M5_LIB_LOGD("Already running");
+            return false;
+        }
+        if (!_unit.inPeriodic()) {
+            M5_LIB_LOGE("Periodic measurements are not running");
+            return false;
+        }
+        uint32_t interval = cfg.interval;
+        if (!interval) {
+            const uint32_t rate = _unit.calculateSamplingRate();
+            interval            = std::max<uint32_t>(rate ? (U::fifoDepth() / 2) * 1000 / rate : 0, 1);
+        }
+        _interval = interval;
+        _gap      = 0;  // The previous run must not mark the first sample of this run
+        _lost.store(0, std::memory_order_relaxed);
+        _running.store(true, std::memory_order_release);
+        _finished.store(false, std::memory_order_release);
+#if defined(ESP_PLATFORM)
+        const BaseType_t core = (cfg.core >= 0) ? cfg.core : tskNO_AFFINITY;
+        if (xTaskCreatePinnedToCore(task, "heart_acq", cfg.stack_size, this, cfg.priority, &_task, core) != pdPASS) {
+            M5_LIB_LOGE("Failed to create the task");
+            _running.store(false, std::memory_order_release);
+            _finished.store(true, std::memory_order_release);
+            return false;
+        }
+#else
+        _thread = std::thread(task, this);
+#endif
+        return true;
+    }
+
+    //! @brief Stop the task (blocked until the task ends)
+    void stop()
+    {
+        if (!_running.exchange(false, std::memory_order_acq_rel)) {
+            return;
+        }
+#if defined(ESP_PLATFORM)
+        while (!_finished.load(std::memory_order_acquire)) {
+            vTaskDelay(1);
+        }
+        _task = nullptr;
+#else
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+#endif
+    }
+
+    //! @brief Is the task running?
+    inline bool running() const
+    {
+        return _running.load(std::memory_order_acquire);
+    }
+    //! @brief Cadence (ms)
+    inline uint32_t interval() const
+    {
+        return _interval;
+    }
+
+    ///@name Consumer
+    ///@{
+    //! @brief Number of the samples in the ring
+    inline size_t available() const
+    {
+        return _ring.size();
+    }
+    /*!
+      @brief Pop the oldest sample
+      @return True if popped
+     */
+    inline bool pop(Sample& s)
+    {
+        return _ring.pop(s);
+    }
+    /*!
+      @brief Pop the samples
+      @return Number of the popped samples
+     */
+    inline size_t pop(Sample* out, const size_t len)
+    {
+        return _ring.pop(out, len);
+    }
+    //! @brief Number of the samples dropped because the ring was full
+    inline uint32_t dropped() const
+    {
+        return _ring.dropped();
+    }
+    /*!
+      @brief Number of the samples lost by the FIFO overflow of the sensor since start()
+      @note The lost and dropped samples are marked as Sample::gap of the next sample
+     */
+    inline uint32_t lost() const
+    {
+        return _lost.load(std::memory_order_relaxed);
+    }
+    ///@}
+
+protected:
+    // Drain the FIFO and push the samples
+    void acquire()
+    {
+        _unit.update(true);
+        if (_unit.updated()) {
+            _gap += _unit.gap();
+            _lost.fetch_add(_unit.gap(), std::memory_order_relaxed);
+            for (auto&& d : _unit.retrievedData()) {
+                // The sample dropped by the full ring is a gap of the next sample too
+                _gap = _ring.push(Sample{d.ir(), d.red(), _gap}) ? 0 : _gap + 1;
+            }
+            _unit.flush();  // The ring is the storage
+        }
+    }
+
+#if defined(ESP_PLATFORM)
+    static void task(void* arg)
+    {
+        auto self           = static_cast<AcquisitionRunner*>(arg);
+        const TickType_t dt = std::max<TickType_t>(pdMS_TO_TICKS(self->_interval), 1);
+        TickType_t last     = xTaskGetTickCount();
+        while (self->_running.load(std::memory_order_acquire)) {
+            self->acquire();
+            vTaskDelayUntil(&last, dt);
+        }
+        self->_finished.store(true, std::memory_order_release);
+        vTaskDelete(nullptr);
+    }
+#else
+    static void task(AcquisitionRunner* self)
+    {
+        const auto dt = std::chrono::milliseconds(self->_interval);
+        auto next     = std::chrono::steady_clock::now();
+        while (self->_running.load(std::memory_order_acquire)) {
+            self->acquire();
+            next += dt;
+            std::this_thread::sleep_until(next);
+        }
+        self->_finished.store(true, std::memory_order_release);
+    }
+#endif
+
+private:
+    U& _unit;
+    SPSCRing<Sample, N> _ring{};
+    uint32_t _interval{};
+    uint32_t _gap{};  // Samples lost before the next sample to be pushed (task only)
+    std::atomic<bool> _running{false}, _finished{true};
+    std::atomic<uint32_t> _lost{0};
+#if defined(ESP_PLATFORM)
+    TaskHandle_t _task{};
+#else
+    std::thread _thread{};
+#endif
+};
+
+}  // namespace heart
+}  // namespace m5
+#endif
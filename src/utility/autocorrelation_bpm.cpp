@@ -0,0 +1,145 @@
+/*
+ * SPDX-FileCopyrightText: 2026 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file autocorrelation_bpm.cpp
+  @brief Estimate BPM from the autocorrelation with the incremental update
+*/
+#include "autocorrelation_bpm.hpp"
+#include <m5_utility/log/library_log.hpp>
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+
+namespace {
+constexpr float q8_scale{256.0f};
+constexpr int32_t q8_limit{1 << 23};  // |product| < 2^46, so the sum of 2^17 samples fits in int64_t
+constexpr float peak_ratio{0.9f};     // The first local maximum over this ratio of the highest is taken
+
+inline int32_t quantize(const float v)
+{
+    const float q = std::fmax(std::fmin(v * q8_scale, static_cast<float>(q8_limit)), -static_cast<float>(q8_limit));
+    return static_cast<int32_t>(std::lrint(q));
+}
+}  // namespace
+
+namespace m5 {
+namespace heart {
+
+AutocorrelationBPM::AutocorrelationBPM(const uint32_t samplingRate, const uint32_t window, const float min_bpm,
+                                       const float max_bpm)
+    : _min_bpm{min_bpm}, _max_bpm{max_bpm}
+{
+    assert(min_bpm > 0.0f && max_bpm > min_bpm && "Invalid range");
+    setup(samplingRate, window);
+}
+
+bool AutocorrelationBPM::setup(const uint32_t samplingRate, const uint32_t window)
+{
+    const uint32_t min_lag = std::max<uint32_t>(static_cast<uint32_t>(60.0f * samplingRate / _max_bpm), 2);
+    const uint32_t max_lag = static_cast<uint32_t>(std::ceil(60.0f * samplingRate / _min_bpm)) + 1;
+    if (!samplingRate || window <= max_lag) {
+        M5_LIB_LOGE("Window must be longer than the longest lag %u/%u", window, max_lag);
+        return false;
+    }
+    const uint32_t capacity = window + max_lag + 1;
+    const uint32_t lags     = max_lag - min_lag + 1;
+    if (!_ring || capacity != _capacity || lags != _max_lag - _min_lag + 1) {
+        _ring.reset(new int32_t[capacity]);
+        _sum.reset(new int64_t[lags]);
+        if (!_ring || !_sum) {
+            M5_LIB_LOGE("Failed to allocate");
+            _capacity = _window = 0;
+            return false;
+        }
+    }
+    _sampling_rate = samplingRate;
+    _window        = window;
+    _min_lag       = min_lag;
+    _max_lag       = max_lag;
+    _capacity      = capacity;
+    clear();
+    return true;
+}
+
+void AutocorrelationBPM::clear()
+{
+    if (_ring) {
+        // Zeros before the first sample, so the products with them are zero
+        std::fill(_ring.get(), _ring.get() + _capacity, 0);
+        std::fill(_sum.get(), _sum.get() + (_max_lag - _min_lag + 1), 0);
+    }
+    _head = _count = 0;
+    _total         = 0;
+    _dirty         = false;
+    _bpm           = 0.0f;
+}
+
+void AutocorrelationBPM::push_back(const float value)
+{
+    const int32_t q = quantize(value);
+    _head           = (_head + 1 < _capacity) ? _head + 1 : 0;
+    _ring[_head]    = q;
+    _count += (_count < _window);
+    _dirty = true;
+
+    // Index of the sample n - k
+    auto index = [this](const uint32_t k) { return (_head >= k) ? _head - k : _head + _capacity - k; };
+
+    // The sample that leaves the window removes its products
+    const int64_t old = _ring[index(_window)];
+    _total += q - old;
+    uint32_t i = index(_min_lag);            // n - lag
+    uint32_t j = index(_window + _min_lag);  // n - window - lag
+    for (uint32_t l = 0; l <= _max_lag - _min_lag; ++l) {
+        _sum[l] += static_cast<int64_t>(q) * _ring[i] - old * _ring[j];
+        i = i ? i - 1 : _capacity - 1;
+        j = j ? j - 1 : _capacity - 1;
+    }
+}
+
+float AutocorrelationBPM::bpm() const
+{
+    if (!_dirty) {
+        return _bpm;
+    }
+    _dirty = false;
+    _bpm   = 0.0f;
+    if (_count < _window) {
+        return _bpm;
+    }
+
+    // Autocovariance c(lag) = sum / window - mean^2
+    const float mean = static_cast<float>(_total) / _window;
+    const float mm   = mean * mean;
+    auto cov         = [this, mm](const uint32_t l) { return static_cast<float>(_sum[l]) / _window - mm; };
+
+    const uint32_t lags = _max_lag - _min_lag + 1;
+    float highest{};
+    for (uint32_t l = 1; l + 1 < lags; ++l) {
+        const float c = cov(l);
+        if (c > cov(l - 1) && c >= cov(l + 1)) {
+            highest = std::fmax(highest, c);
+        }
+    }
+    if (highest <= 0.0f) {
+        return _bpm;  // No periodicity
+    }
+    for (uint32_t l = 1; l + 1 < lags; ++l) {
+        const float c = cov(l);
+        if (c > cov(l - 1) && c >= cov(l + 1) && c >= highest * peak_ratio) {
+            // Parabolic interpolation between the neighbors
+            const float left = cov(l - 1), right = cov(l + 1);
+            const float den  = left - 2.0f * c + right;
+            const float lag  = _min_lag + l + ((den != 0.0f) ? 0.5f * (left - right) / den : 0.0f);
+            _bpm             = 60.0f * _sampling_rate / lag;
+            break;
+        }
+    }
+    return _bpm;
+}
+
+}  // namespace heart
+}  // namespace m5
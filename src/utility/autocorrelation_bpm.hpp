@@ -0,0 +1,106 @@
+/*
+ * SPDX-FileCopyrightText: 2026 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file autocorrelation_bpm.hpp
+  @brief Estimate BPM from the autocorrelation with the incremental update
+*/
+#ifndef M5_UNIT_HEART_UTILITY_AUTOCORRELATION_BPM_HPP
+#define M5_UNIT_HEART_UTILITY_AUTOCORRELATION_BPM_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+namespace m5 {
+namespace heart {
+
+/*!
+  @class AutocorrelationBPM
+  @brief Estimate BPM from the autocorrelation over the window
+  @details The lag products of the plausible RR range (min - max BPM) are kept as the running sums, a sample adds
+  its products and the sample that leaves the window removes its products, so push_back() is O(lags) instead of
+  O(window * lags). The samples are quantized to Q8 and the sums are int64_t, so adding and removing is exact and
+  the sums do not drift over long runs.
+  The autocovariance (the mean of the window removed) is used, so the DC and the slow wander left by the high-pass
+  filter do not bias the lags. BPM is from the first lag of the highest local maxima, refined by the parabolic
+  interpolation, and calculated only when bpm() is called after new samples
+  @note Storage is allocated only in the constructor and setup()
+ */
+class AutocorrelationBPM {
+public:
+    /*!
+      @brief Constructor
+      @param samplingRate Sampling rate
+      @param window Number of samples of the window
+      @param min_bpm Lowest BPM (longest lag)
+      @param max_bpm Highest BPM (shortest lag)
+     */
+    AutocorrelationBPM(const uint32_t samplingRate, const uint32_t window, const float min_bpm = 40.0f,
+                       const float max_bpm = 220.0f);
+
+    /*!
+      @brief Setup
+      @param samplingRate Sampling rate
+      @param window Number of samples of the window
+      @return True if successful
+      @note Clear inner data
+     */
+    bool setup(const uint32_t samplingRate, const uint32_t window);
+
+    //! @brief Gets the sampling rate
+    inline uint32_t samplingRate() const
+    {
+        return _sampling_rate;
+    }
+    //! @brief Gets the window
+    inline uint32_t window() const
+    {
+        return _window;
+    }
+    //! @brief Shortest lag
+    inline uint32_t minLag() const
+    {
+        return _min_lag;
+    }
+    //! @brief Longest lag
+    inline uint32_t maxLag() const
+    {
+        return _max_lag;
+    }
+
+    /*!
+      @brief Push back a filtered sample
+      @param value Sample
+     */
+    void push_back(const float value);
+
+    /*!
+      @brief Gets the BPM
+      @return BPM, or zero if the window is not filled or no periodicity
+      @note Calculated on the first call after new samples (O(lags))
+     */
+    float bpm() const;
+
+    //! @brief Clear inner data
+    void clear();
+
+private:
+    float _min_bpm{}, _max_bpm{};
+    uint32_t _sampling_rate{}, _window{};
+    uint32_t _min_lag{}, _max_lag{};
+
+    std::unique_ptr<int32_t[]> _ring{};  // Quantized samples [window + max lag]
+    std::unique_ptr<int64_t[]> _sum{};   // Sum of the lag products [max lag - min lag + 1]
+    uint32_t _capacity{}, _head{}, _count{};
+    int64_t _total{};  // Sum of the samples in the window
+
+    mutable bool _dirty{};
+    mutable float _bpm{};
+};
+
+}  // namespace heart
+}  // namespace m5
+#endif
@@ -0,0 +1,277 @@
+/*
+ * SPDX-FileCopyrightText: 2026 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file biquad.hpp
+  @brief IIR biquad filter and the cascade
+*/
+#ifndef M5_UNIT_HEART_UTILITY_BIQUAD_HPP
+#define M5_UNIT_HEART_UTILITY_BIQUAD_HPP
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cassert>
+
+namespace m5 {
+namespace heart {
+
+/*!
+  @class Biquad
+  @brief Second order IIR section in Direct Form II transposed
+  @details y = b0 * x + z1, z1 = b1 * x - a1 * y + z2, z2 = b2 * x - a2 * y (a0 is normalized to 1)
+ */
+class Biquad {
+public:
+    //! @brief Coefficients (a0 is normalized to 1)
+    struct Coefficients {
+        float b0{1.0f}, b1{}, b2{};
+        float a1{}, a2{};
+    };
+
+    ///@name Design (RBJ audio EQ cookbook)
+    ///@{
+    /*! @brief Low-pass
+        @param cutoff Cutoff frequency in Hz
+        @param sampling_rate Sampling rate in Hz
+        @param q Quality factor (0.7071: Butterworth) */
+    static Coefficients lowpass(const float cutoff, const float sampling_rate, const float q = 0.70710678f)
+    {
+        const float c = std::cos(omega(cutoff, sampling_rate));
+        return normalize((1.0f - c) * 0.5f, 1.0f - c, (1.0f - c) * 0.5f, c, alpha(cutoff, sampling_rate, q));
+    }
+    /*! @brief High-pass
+        @param cutoff Cutoff frequency in Hz
+        @param sampling_rate Sampling rate in Hz
+        @param q Quality factor (0.7071: Butterworth) */
+    static Coefficients highpass(const float cutoff, const float sampling_rate, const float q = 0.70710678f)
+    {
+        const float c = std::cos(omega(cutoff, sampling_rate));
+        return normalize((1.0f + c) * 0.5f, -(1.0f + c), (1.0f + c) * 0.5f, c, alpha(cutoff, sampling_rate, q));
+    }
+    /*! @brief Band-pass (0 dB peak gain)
+        @param center Center frequency in Hz
+        @param sampling_rate Sampling rate in Hz
+        @param q Quality factor */
+    static Coefficients bandpass(const float center, const float sampling_rate, const float q)
+    {
+        const float a = alpha(center, sampling_rate, q);
+        return normalize(a, 0.0f, -a, std::cos(omega(center, sampling_rate)), a);
+    }
+    /*! @brief Notch
+        @param center Center frequency in Hz
+        @param sampling_rate Sampling rate in Hz
+        @param q Quality factor
+        @note Pass-through if the center is not below the Nyquist frequency */
+    static Coefficients notch(const float center, const float sampling_rate, const float q = 10.0f)
+    {
+        if (center * 2.0f >= sampling_rate) {
+            return Coefficients{};
+        }
+        const float c = std::cos(omega(center, sampling_rate));
+        return normalize(1.0f, -2.0f * c, 1.0f, c, alpha(center, sampling_rate, q));
+    }
+    ///@}
+
+    //! @brief Set the coefficients and reset the state
+    inline void set(const Coefficients& c)
+    {
+        _c = c;
+        reset();
+    }
+    //! @brief Gets the coefficients
+    inline const Coefficients& coefficients() const
+    {
+        return _c;
+    }
+    //! @brief Reset the state
+    inline void reset()
+    {
+        _z1 = _z2 = 0.0f;
+    }
+
+    /*! @brief Set the state as the input has been x for a long time
+        @param x Input sample
+        @return Output sample (DC gain * x)
+        @note Avoids the step response from zero at the start (e.g. the DC of the raw samples) */
+    inline float prime(const float x)
+    {
+        const float den = 1.0f + _c.a1 + _c.a2;
+        const float y   = (den != 0.0f) ? (_c.b0 + _c.b1 + _c.b2) / den * x : 0.0f;
+        _z1             = y - _c.b0 * x;
+        _z2             = _c.b2 * x - _c.a2 * y;
+        return y;
+    }
+
+    /*! @brief Process a sample
+        @param x Input sample
+        @return Output sample */
+    inline float process(const float x)
+    {
+        const float y = _c.b0 * x + _z1;
+        _z1           = _c.b1 * x - _c.a1 * y + _z2;
+        _z2           = _c.b2 * x - _c.a2 * y;
+        return y;
+    }
+
+private:
+    static inline float omega(const float f, const float sampling_rate)
+    {
+        constexpr float pi{3.14159265358979323846f};
+        return 2.0f * pi * f / sampling_rate;
+    }
+    static inline float alpha(const float f, const float sampling_rate, const float q)
+    {
+        return std::sin(omega(f, sampling_rate)) / (2.0f * q);
+    }
+    // a0 = 1 + alpha, a1 = -2cos, a2 = 1 - alpha
+    static inline Coefficients normalize(const float b0, const float b1, const float b2, const float c, const float a)
+    {
+        const float a0 = 1.0f + a;
+        Coefficients r{};
+        r.b0 = b0 / a0;
+        r.b1 = b1 / a0;
+        r.b2 = b2 / a0;
+        r.a1 = -2.0f * c / a0;
+        r.a2 = (1.0f - a) / a0;
+        return r;
+    }
+
+    Coefficients _c{};
+    float _z1{}, _z2{};
+};
+
+/*!
+  @class BiquadCascade
+  @brief Cascade of the biquad sections
+  @tparam N Number of the sections
+  @note The per-sample kernel has no branches, and the loop over the sections is unrolled by the compiler
+ */
+template <size_t N>
+class BiquadCascade {
+    static_assert(N >= 1, "N must be greater or equal than 1");
+
+public:
+    //! @brief Number of the sections
+    static constexpr size_t sections()
+    {
+        return N;
+    }
+
+    /*! @brief Set the coefficients of the section and reset the state
+        @param idx Index of the section
+        @param c Coefficients */
+    inline void set(const size_t idx, const Biquad::Coefficients& c)
+    {
+        assert(idx < N && "index overflow");
+        _section[idx].set(c);
+    }
+    //! @brief Gets the section
+    inline const Biquad& section(const size_t idx) const
+    {
+        assert(idx < N && "index overflow");
+        return _section[idx];
+    }
+    //! @brief Reset the state of all sections
+    inline void reset()
+    {
+        for (auto&& s : _section) {
+            s.reset();
+        }
+    }
+    /*! @brief Set the state of all sections as the input has been x for a long time
+        @param x Input sample
+        @return Output sample */
+    inline float prime(float x)
+    {
+        for (auto&& s : _section) {
+            x = s.prime(x);
+        }
+        return x;
+    }
+
+    /*! @brief Process a sample through all sections
+        @param x Input sample
+        @return Output sample */
+    inline float process(float x)
+    {
+        for (auto&& s : _section) {
+            x = s.process(x);
+        }
+        return x;
+    }
+
+private:
+    std::array<Biquad, N> _section{};
+};
+
+/*!
+  @class BiquadFilter
+  @brief Filter policy of the pulse monitor with the biquad cascade
+  @details Band-pass (2nd order high-pass and 2nd order low-pass, Butterworth) and the notch of the mains,
+  and invert polarity as Filter. The coefficients are calculated only in setSamplingRate()
+  @note The notch is pass-through if the mains frequency is not below the Nyquist frequency (e.g. 50 Hz at 100 sps)
+  @sa FilteredPulseMonitor
+ */
+class BiquadFilter {
+public:
+    /*! @brief Constructor
+        @param low Lower cutoff frequency in Hz
+        @param high Upper cutoff frequency in Hz
+        @param mains Mains frequency to be removed in Hz (50/60)
+        @note setSamplingRate() must be called before process() */
+    explicit BiquadFilter(const float low = 0.5f, const float high = 5.0f, const float mains = 50.0f)
+        : _low{low}, _high{high}, _mains{mains}
+    {
+    }
+
+    //! @brief Gets the sampling rate
+    inline float samplingRate() const
+    {
+        return _samplingRate;
+    }
+
+    /*! @brief Set the sampling rate and reset filter state
+        @param sampling_rate Sampling rate in Hz */
+    void setSamplingRate(const float sampling_rate)
+    {
+        _samplingRate = sampling_rate;
+        _cascade.set(0, Biquad::highpass(_low, sampling_rate));
+        _cascade.set(1, Biquad::lowpass(_high, sampling_rate));
+        _cascade.set(2, Biquad::notch(_mains, sampling_rate));
+        clear();
+    }
+    //! @brief Reset the filter state, the next sample is taken as the DC offset
+    inline void clear()
+    {
+        _cascade.reset();
+        _offset = 0.0f;
+        _latch  = 1.0f;
+    }
+
+    /*! @brief Process a sample through the filter
+        @param value Input sample
+        @return Filtered and inverted output
+        @note The first sample after setSamplingRate() or clear() is latched as the DC offset and subtracted, which
+        is the same as priming the state (the DC gain of the band-pass is 0), so the DC of the raw samples does not
+        ring. The latch is arithmetic, so the per-sample kernel has no branches */
+    inline float process(const float value)
+    {
+        _offset += _latch * (value - _offset);
+        _latch = 0.0f;
+        return -_cascade.process(value - _offset);
+    }
+
+private:
+    BiquadCascade<3> _cascade{};
+    float _low{}, _high{}, _mains{};
+    float _samplingRate{};
+    float _offset{};     // DC offset latched from the first sample
+    float _latch{1.0f};  // 1 until the first sample, then 0
+};
+
+}  // namespace heart
+}  // namespace m5
+#endif
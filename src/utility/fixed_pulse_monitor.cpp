@@ -0,0 +1,113 @@
+/*
+ * SPDX-FileCopyrightText: 2026 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file fixed_pulse_monitor.cpp
+  @brief Calculate BPM and SpO2 in fixed-point arithmetic
+*/
+#include "fixed_pulse_monitor.hpp"
+
+namespace {
+using namespace m5::heart::fixed;
+
+constexpr uint32_t max_ratio{1U << (Q16 + 8)};  // Ratios beyond are clamped anyway (R >= 256)
+constexpr int64_t spo2_slope{5965};             // 23.3 in Q8
+constexpr int64_t spo2_offset{26214};           // 0.4 in Q16
+constexpr int64_t spo2_min{80 << Q8}, spo2_max{100 << Q8};
+
+inline uint64_t ratio_q16(const uint64_t num, const uint64_t den)
+{
+    return std::min<uint64_t>((num << Q16) / den, max_ratio);
+}
+
+}  // namespace
+
+namespace m5 {
+namespace heart {
+
+namespace fixed {
+uint32_t isqrt(uint64_t v)
+{
+    uint64_t root{}, bit{1ULL << 62};
+    while (bit > v) {
+        bit >>= 2;
+    }
+    while (bit) {
+        if (v >= root + bit) {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return static_cast<uint32_t>(root);
+}
+}  // namespace fixed
+
+// class FixedFilter
+void FixedFilter::setSamplingRate(const float cutoff, const float sampling_rate)
+{
+    constexpr float pi{3.14159265358979323846f};
+    const float dt = 1.0f / sampling_rate;
+    const float RC = 1.0f / (2.0f * pi * cutoff);
+    _cutoff        = cutoff;
+    _alpha         = to_q15(RC / (RC + dt));
+    clear();
+}
+
+// struct FixedSample
+bool FixedSample::rms_ratio(const sum_type sumred, const sum_type sumir, const dc_type avered, const dc_type aveir,
+                            ratio_type& R)
+{
+    if (avered <= 0 || aveir <= 0) {
+        return false;
+    }
+    const uint32_t rms_red = isqrt(sumred);
+    const uint32_t rms_ir  = isqrt(sumir);
+    if (!rms_ir) {
+        R = rms_red ? max_ratio : 0;  // R is infinite or NaN (SpO2 80 or 100 as PulseMonitor)
+        return true;
+    }
+    // R = (rms_red / avered) / (rms_ir / aveir)
+    R = (ratio_q16(rms_red, rms_ir) * ratio_q16(static_cast<uint64_t>(aveir), static_cast<uint64_t>(avered))) >> Q16;
+    return true;
+}
+
+bool FixedSample::peak_ratio(const input_type acred, const input_type acir, const dc_type avered,
+                             const dc_type aveir, ratio_type& R)
+{
+    if (!acir || avered <= 0 || aveir <= 0) {
+        return false;
+    }
+    // R = (acred / avered) / (acir / aveir)
+    R = ratio_q16(static_cast<uint64_t>(acred) * static_cast<uint64_t>(aveir),
+                  static_cast<uint64_t>(acir) * static_cast<uint64_t>(avered));
+    return true;
+}
+
+FixedSample::spo2_type FixedSample::spo2(const ratio_type R)
+{
+    // Same approximation as FloatSample
+    const int64_t r    = static_cast<int64_t>(std::min<uint64_t>(R, max_ratio));
+    const int64_t spo2 = (100 << Q8) - ((spo2_slope * (r - spo2_offset)) >> Q16);
+    return static_cast<spo2_type>(std::max<int64_t>(std::min<int64_t>(spo2, spo2_max), spo2_min));
+}
+
+// class FixedPulseMonitor
+template class FilteredPulseMonitor<FixedFilter, FixedSample>;
+
+uint32_t FixedPulseMonitor::bpmQ8() const
+{
+    if (inGoertzelBPM() || inAutocorrelationBPM()) {
+        return static_cast<uint32_t>(bpm() * (1U << Q8) + 0.5f);
+    }
+    // BPM = 60 * rate * intervals / span
+    const uint64_t beats = static_cast<uint64_t>(60U * samplingRate()) * _intervals;
+    return _span ? static_cast<uint32_t>((beats << Q8) / _span) : 0;
+}
+
+}  // namespace heart
+}  // namespace m5
@@ -0,0 +1,193 @@
+/*
+ * SPDX-FileCopyrightText: 2026 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file fixed_pulse_monitor.hpp
+  @brief Calculate BPM and SpO2 in fixed-point arithmetic
+  @details For the targets without FPU (e.g. ESP32-C3/C6/H2), where every float operation is emulated
+*/
+#ifndef M5_UNIT_HEART_UTILITY_FIXED_PULSE_MONITOR_HPP
+#define M5_UNIT_HEART_UTILITY_FIXED_PULSE_MONITOR_HPP
+
+#include "pulse_monitor.hpp"
+#include <cstdint>
+
+namespace m5 {
+namespace heart {
+
+///@cond
+namespace fixed {
+constexpr uint32_t Q8{8};    // Samples
+constexpr uint32_t Q15{15};  // Coefficients
+constexpr uint32_t Q16{16};  // Ratios
+
+constexpr int32_t dc_alpha{1638};     // 0.05 in Q15 (DC EMA for SpO2)
+constexpr uint32_t dev_shift{Q8 - 4};  // Deviations are summed in Q4 (a 1 sec of 3200 sps fits)
+
+// Q15 coefficient from the float (at configuration time only)
+inline int32_t to_q15(const float v)
+{
+    return static_cast<int32_t>(v * (1U << Q15) + 0.5f);
+}
+inline int32_t mul_q15(const int32_t coef, const int32_t v)
+{
+    return static_cast<int32_t>((static_cast<int64_t>(coef) * v) >> Q15);
+}
+uint32_t isqrt(uint64_t v);
+}  // namespace fixed
+///@endcond
+
+/*!
+  @class FixedFilter
+  @brief Fixed-point version of Filter (high-pass filter, EMA(0.95) and invert polarity)
+  @details Samples are Q8 (24.8) in int32_t, and coefficients are Q15
+  @note The filter policy of FixedPulseMonitor
+ */
+class FixedFilter {
+public:
+    //! @brief Constructor (5 Hz cutoff at 100 sps, as FixedPulseMonitor)
+    FixedFilter() : FixedFilter(5.0f, 100.0f)
+    {
+    }
+    /*! @brief Constructor
+        @param cutoff Cutoff frequency in Hz
+        @param sampling_rate Sampling rate in Hz */
+    FixedFilter(const float cutoff, const float sampling_rate)
+    {
+        setSamplingRate(cutoff, sampling_rate);
+    }
+
+    /*! @brief Set the sampling rate and reset filter state
+        @param cutoff Cutoff frequency in Hz
+        @param sampling_rate Sampling rate in Hz */
+    void setSamplingRate(const float cutoff, const float sampling_rate);
+    /*! @brief Set the sampling rate with the current cutoff and reset filter state
+        @param sampling_rate Sampling rate in Hz */
+    inline void setSamplingRate(const float sampling_rate)
+    {
+        setSamplingRate(_cutoff, sampling_rate);
+    }
+    //! @brief Reset the filter state as constructed (the coefficient is kept)
+    inline void clear()
+    {
+        _prevIn = _prevOut = 0;
+        _primed            = false;
+    }
+
+    /*! @brief Process a raw sample through the filter
+        @param value Raw sample (up to 18 bits)
+        @return Filtered and inverted output (Q8) */
+    inline int32_t process(const int32_t value)
+    {
+        const int32_t in = value << fixed::Q8;
+        const int32_t hp = fixed::mul_q15(_alpha, _prevOut + in - _prevIn);
+        // EMA(0.95), the first value is taken as is
+        const int32_t out = _primed ? _prevOut + fixed::mul_q15(ema_alpha, hp - _prevOut) : hp;
+        _primed           = true;
+        _prevIn           = in;
+        _prevOut          = out;
+        return -out;
+    }
+
+private:
+    static constexpr int32_t ema_alpha{31130};  // 0.95 in Q15
+
+    float _cutoff{};
+    int32_t _alpha{};
+    int32_t _prevIn{}, _prevOut{};
+    bool _primed{};
+};
+
+/*!
+  @struct FixedSample
+  @brief Arithmetic of the samples in fixed-point
+  @details Raw samples are the integers of the sensors (18 bits MAX30102, 16 bits MAX30100). The filtered samples,
+  the DC and SpO2 are Q8, the squared deviations are Q4 and R is Q16
+  @sa FloatSample
+ */
+struct FixedSample {
+    using input_type = uint32_t;  //!< @brief Raw sample
+    using value_type = int32_t;   //!< @brief Filtered sample (Q8)
+    using dc_type    = int32_t;   //!< @brief DC of the raw samples (Q8)
+    using sum_type   = uint64_t;  //!< @brief Squared deviation and the sum of them (Q4)
+    using ratio_type = uint64_t;  //!< @brief Ratio R of Red to IR (Q16)
+    using spo2_type  = uint32_t;  //!< @brief SpO2 (Q8)
+
+    //! @brief Minimum value for a peak
+    static constexpr value_type threshold()
+    {
+        return 50 << fixed::Q8;
+    }
+    //! @brief Q8 value as float
+    template <typename T>
+    static inline float to_float(const T v)
+    {
+        return v / static_cast<float>(1U << fixed::Q8);
+    }
+    //! @brief Sample i of the n - 1 samples between prev and next (linear interpolation)
+    static inline input_type interpolate(const input_type prev, const input_type next, const uint32_t i,
+                                         const uint32_t n)
+    {
+        return static_cast<input_type>(prev + (static_cast<int64_t>(next) - prev) * i / n);
+    }
+    //! @brief Update the DC (EMA(0.95)) with the raw sample
+    static inline void average(dc_type& ave, const input_type v)
+    {
+        ave += fixed::mul_q15(fixed::dc_alpha, (static_cast<int32_t>(v) << fixed::Q8) - ave);
+    }
+    //! @brief Squared deviation of the raw sample from the DC
+    static inline sum_type deviation(const input_type v, const dc_type ave)
+    {
+        const int64_t d = ((static_cast<int32_t>(v) << fixed::Q8) - ave) >> fixed::dev_shift;
+        return static_cast<sum_type>(d * d);
+    }
+    /*!
+      @brief R from the sums of the squared deviations (RMS) and the DC
+      @return True if R is available
+     */
+    static bool rms_ratio(const sum_type sumred, const sum_type sumir, const dc_type avered, const dc_type aveir,
+                          ratio_type& R);
+    /*!
+      @brief R from the peak-to-peak (AC) and the DC
+      @return True if R is available
+     */
+    static bool peak_ratio(const input_type acred, const input_type acir, const dc_type avered, const dc_type aveir,
+                           ratio_type& R);
+    //! @brief SpO2 from R
+    static spo2_type spo2(const ratio_type R);
+};
+
+///@cond
+extern template class FilteredPulseMonitor<FixedFilter, FixedSample>;
+///@endcond
+
+/*!
+  @class FixedPulseMonitor
+  @brief Fixed-point version of PulseMonitor
+  @details Takes the raw integers of the sensors (18 bits MAX30102, 16 bits MAX30100) and processes them without
+  float operations. Floats are used only in the configuration, the float accessors and the BPM estimators.
+  The chain is the same as PulseMonitor (FilteredPulseMonitor with FixedFilter and FixedSample), so process(),
+  markGap(), the sliding window and beat-synchronous SpO2 and the BPM estimators are available as well
+  @note Compared with PulseMonitor on the same samples, BPM matches within 1.0, SpO2 within 0.5 and latestIR() within
+  4.0 (quantization of the coefficients)
+  @note The BPM estimators (enableGoertzelBPM(), enableAutocorrelationBPM()) take the filtered samples in float, which
+  is emulated on the targets without FPU
+ */
+class FixedPulseMonitor : public FilteredPulseMonitor<FixedFilter, FixedSample> {
+public:
+    using FilteredPulseMonitor<FixedFilter, FixedSample>::FilteredPulseMonitor;
+
+    //! @brief Gets the BPM (Q8)
+    uint32_t bpmQ8() const;
+    //! @brief Gets the SpO2 (Q8)
+    inline uint32_t SpO2Q8() const
+    {
+        return _spo2;
+    }
+};
+
+}  // namespace heart
+}  // namespace m5
+#endif
@@ -0,0 +1,107 @@
+/*
+ * SPDX-FileCopyrightText: 2026 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file fixed_ring.hpp
+  @brief Ring buffer with the compile-time capacity
+*/
+#ifndef M5_UNIT_HEART_UTILITY_FIXED_RING_HPP
+#define M5_UNIT_HEART_UTILITY_FIXED_RING_HPP
+
+#include <array>
+#include <cstddef>
+#include <cassert>
+
+namespace m5 {
+namespace heart {
+
+/*!
+  @class FixedRing
+  @brief Ring buffer in std::array (no heap, no division on access)
+  @tparam T Element type
+  @tparam N Capacity
+  @note The oldest element is overwritten when full, as m5::container::CircularBuffer
+ */
+template <typename T, size_t N>
+class FixedRing {
+    static_assert(N >= 1, "N must be greater or equal than 1");
+
+public:
+    using value_type = T;
+    using size_type  = size_t;
+
+    ///@name Properties
+    ///@{
+    inline constexpr size_type capacity() const
+    {
+        return N;
+    }
+    inline size_type size() const
+    {
+        return _size;
+    }
+    inline bool empty() const
+    {
+        return _size == 0;
+    }
+    inline bool full() const
+    {
+        return _size == N;
+    }
+    ///@}
+
+    ///@name Element access
+    ///@{
+    //! @brief Element (0 is the oldest)
+    inline const T& operator[](const size_type i) const
+    {
+        assert(i < _size && "index overflow");
+        return _buf[wrap(_head + i)];
+    }
+    inline T& operator[](const size_type i)
+    {
+        assert(i < _size && "index overflow");
+        return _buf[wrap(_head + i)];
+    }
+    ///@}
+
+    ///@name Modifiers
+    ///@{
+    inline void push_back(const T& v)
+    {
+        _buf[wrap(_head + _size)] = v;
+        if (_size < N) {
+            ++_size;
+        } else {
+            _head = wrap(_head + 1);
+        }
+    }
+    inline void pop_front()
+    {
+        if (_size) {
+            _head = wrap(_head + 1);
+            --_size;
+        }
+    }
+    inline void clear()
+    {
+        _head = _size = 0;
+    }
+    ///@}
+
+private:
+    // Index is less than N * 2
+    inline static size_type wrap(const size_type i)
+    {
+        return (i >= N) ? i - N : i;
+    }
+
+    std::array<T, N> _buf{};
+    size_type _head{}, _size{};
+};
+
+}  // namespace heart
+}  // namespace m5
+#endif
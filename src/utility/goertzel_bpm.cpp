@@ -0,0 +1,132 @@
+/*
+ * SPDX-FileCopyrightText: 2026 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file goertzel_bpm.cpp
+  @brief Estimate BPM from the dominant frequency by the Goertzel bank
+*/
+#include "goertzel_bpm.hpp"
+#include <m5_utility/log/library_log.hpp>
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+
+namespace {
+constexpr float pi{3.14159265358979323846f};
+constexpr float subharmonic_ratio{0.2f};  // Power ratio of the fundamental to the harmonic to be taken
+constexpr uint32_t decimated_rate{25};    // Sampling rate of the bank (enough for 220 BPM)
+}  // namespace
+
+namespace m5 {
+namespace heart {
+
+GoertzelBPM::GoertzelBPM(const uint32_t samplingRate, const uint32_t window, const uint32_t cadence,
+                         const float min_bpm, const float max_bpm, const float step)
+    : _min_bpm{min_bpm}, _step{step}
+{
+    assert(min_bpm > 0.0f && max_bpm >= min_bpm && step > 0.0f && "Invalid range");
+    _bins = static_cast<uint32_t>((max_bpm - min_bpm) / step) + 1;
+    setup(samplingRate, window, cadence);
+}
+
+bool GoertzelBPM::setup(const uint32_t samplingRate, const uint32_t window, const uint32_t cadence)
+{
+    if (!samplingRate || window < 2) {
+        M5_LIB_LOGE("Invalid settings %u/%u", samplingRate, window);
+        return false;
+    }
+    const uint32_t decimation = std::max<uint32_t>(samplingRate / decimated_rate, 1);
+    const uint32_t length     = std::max<uint32_t>(window / decimation, 2);
+    if (length != _length) {
+        _ring.reset(new float[length]);
+        _hann.reset(new float[length]);
+        if (!_ring || !_hann) {
+            M5_LIB_LOGE("Failed to allocate");
+            _window = _length = 0;
+            return false;
+        }
+        for (uint32_t i = 0; i < length; ++i) {
+            _hann[i] = 0.5f - 0.5f * std::cos(2.0f * pi * i / (length - 1));
+        }
+    }
+    if (!_coeff) {
+        _coeff.reset(new float[_bins]);
+        _power.reset(new float[_bins]);
+    }
+    _sampling_rate   = samplingRate;
+    _window          = window;
+    _cadence         = cadence ? cadence : 1;
+    _decimation      = decimation;
+    _length          = length;
+    const float rate = static_cast<float>(samplingRate) / decimation;
+    for (uint32_t k = 0; k < _bins; ++k) {
+        const float hz = (_min_bpm + _step * k) / 60.0f;
+        _coeff[k]      = 2.0f * std::cos(2.0f * pi * hz / rate);
+    }
+    clear();
+    return true;
+}
+
+void GoertzelBPM::clear()
+{
+    _pos = _size = _since = _acc_count = 0;
+    _acc = _bpm = 0.0f;
+}
+
+void GoertzelBPM::calculate()
+{
+    // Oldest first (the ring is full), mean removed and windowed
+    float mean{};
+    for (uint32_t i = 0; i < _length; ++i) {
+        mean += _ring[i];
+    }
+    mean /= _length;
+
+    uint32_t peak{};
+    for (uint32_t k = 0; k < _bins; ++k) {
+        const float c = _coeff[k];
+        float s1{}, s2{};
+        uint32_t idx = _pos;
+        for (uint32_t n = 0; n < _length; ++n) {
+            const float s = (_ring[idx] - mean) * _hann[n] + c * s1 - s2;
+            s2            = s1;
+            s1            = s;
+            idx           = (idx + 1 < _length) ? idx + 1 : 0;
+        }
+        _power[k] = s1 * s1 + s2 * s2 - c * s1 * s2;
+        if (_power[k] > _power[peak]) {
+            peak = k;
+        }
+    }
+    if (_power[peak] <= 0.0f) {
+        _bpm = 0.0f;
+        return;
+    }
+    // The harmonic can be stronger than the fundamental at low heart rates (the high-pass filter attenuates it),
+    // so take the half if it has the enough power
+    const float half = (_min_bpm + _step * peak) * 0.5f;
+    if (half >= _min_bpm) {
+        const uint32_t k = static_cast<uint32_t>((half - _min_bpm) / _step + 0.5f);
+        uint32_t sub     = k;
+        for (uint32_t i = (k ? k - 1 : 0); i <= std::min(k + 1, _bins - 1); ++i) {
+            sub = (_power[i] > _power[sub]) ? i : sub;
+        }
+        if (_power[sub] >= _power[peak] * subharmonic_ratio) {
+            peak = sub;
+        }
+    }
+
+    // Parabolic interpolation between the neighbors
+    float delta{};
+    if (peak > 0 && peak + 1 < _bins) {
+        const float l   = _power[peak - 1], m = _power[peak], r = _power[peak + 1];
+        const float den = l - 2.0f * m + r;
+        delta           = (den != 0.0f) ? std::max(-0.5f, std::min(0.5f, 0.5f * (l - r) / den)) : 0.0f;
+    }
+    _bpm = _min_bpm + _step * (peak + delta);
+}
+
+}  // namespace heart
+}  // namespace m5
@@ -0,0 +1,131 @@
+/*
+ * SPDX-FileCopyrightText: 2026 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file goertzel_bpm.hpp
+  @brief Estimate BPM from the dominant frequency by the Goertzel bank
+*/
+#ifndef M5_UNIT_HEART_UTILITY_GOERTZEL_BPM_HPP
+#define M5_UNIT_HEART_UTILITY_GOERTZEL_BPM_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+namespace m5 {
+namespace heart {
+
+/*!
+  @class GoertzelBPM
+  @brief Estimate BPM from the dominant cardiac frequency over the window
+  @details The power of each BPM bin (min - max BPM, step BPM) is calculated by the Goertzel algorithm over the
+  latest window samples (Hann window, mean removed), and the peak bin is refined by the parabolic interpolation.
+  push_back() only stores the sample, and the bank is calculated every cadence samples.
+  The samples are decimated (averaged) to around 25 sps, since the cardiac band is below 4 Hz, so the cost of the
+  bank does not grow with the square of the sampling rate.
+  It does not depend on the peak threshold, so it works on the low perfusion signals
+  @note Storage is allocated only in the constructor and setup()
+ */
+class GoertzelBPM {
+public:
+    /*!
+      @brief Constructor
+      @param samplingRate Sampling rate
+      @param window Number of samples of the window
+      @param cadence Calculate every cadence samples
+      @param min_bpm Lowest BPM of the bank
+      @param max_bpm Highest BPM of the bank
+      @param step BPM step of the bins
+     */
+    GoertzelBPM(const uint32_t samplingRate, const uint32_t window, const uint32_t cadence,
+                const float min_bpm = 40.0f, const float max_bpm = 220.0f, const float step = 1.0f);
+
+    /*!
+      @brief Setup
+      @param samplingRate Sampling rate
+      @param window Number of samples of the window
+      @param cadence Calculate every cadence samples
+      @return True if successful
+      @note Clear inner data
+     */
+    bool setup(const uint32_t samplingRate, const uint32_t window, const uint32_t cadence);
+
+    //! @brief Gets the sampling rate
+    inline uint32_t samplingRate() const
+    {
+        return _sampling_rate;
+    }
+    //! @brief Gets the window
+    inline uint32_t window() const
+    {
+        return _window;
+    }
+    //! @brief Gets the cadence
+    inline uint32_t cadence() const
+    {
+        return _cadence;
+    }
+    //! @brief Number of the bins
+    inline uint32_t bins() const
+    {
+        return _bins;
+    }
+
+    /*!
+      @brief Push back a filtered sample
+      @param value Sample
+      @return True if BPM is calculated on this sample
+     */
+    inline bool push_back(const float value)
+    {
+        _acc += value;
+        if (++_acc_count == _decimation) {
+            _ring[_pos] = _acc / _decimation;
+            _pos        = (_pos + 1 < _length) ? _pos + 1 : 0;
+            _size += (_size < _length);
+            _acc       = 0.0f;
+            _acc_count = 0;
+        }
+        if (++_since < _cadence || _size < _length) {
+            return false;
+        }
+        _since = 0;
+        calculate();
+        return true;
+    }
+
+    /*!
+      @brief Gets the BPM
+      @return BPM at the latest calculation, or zero if not calculated yet
+     */
+    inline float bpm() const
+    {
+        return _bpm;
+    }
+
+    //! @brief Clear inner data
+    void clear();
+
+protected:
+    void calculate();
+
+private:
+    uint32_t _sampling_rate{}, _window{}, _cadence{};
+    uint32_t _decimation{}, _length{};  // Samples of the ring are the averages of decimation samples
+    float _min_bpm{}, _step{};
+    uint32_t _bins{};
+
+    std::unique_ptr<float[]> _ring{};   // Decimated samples [length]
+    std::unique_ptr<float[]> _hann{};   // Hann window [length]
+    std::unique_ptr<float[]> _coeff{};  // 2cos(w) of the bins [bins]
+    std::unique_ptr<float[]> _power{};  // Power of the bins [bins]
+    uint32_t _pos{}, _size{}, _since{}, _acc_count{};
+    float _acc{};
+    float _bpm{};
+};
+
+}  // namespace heart
+}  // namespace m5
+#endif
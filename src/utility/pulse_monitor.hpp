@@ -13,8 +13,17 @@
 #include <limits>
 #include <cmath>
 #include <cassert>
-#include <deque>
+#include <algorithm>
+#include <memory>
+#include <iterator>
+#include <type_traits>
+#include <utility>
 #include <m5_utility/log/library_log.hpp>
+#include <m5_utility/container/circular_buffer.hpp>
+#include "fixed_ring.hpp"
+#include "biquad.hpp"
+#include "goertzel_bpm.hpp"
+#include "autocorrelation_bpm.hpp"
 
 namespace m5 {
 /*!
@@ -61,9 +70,14 @@ private:
 /*!
   @class Filter
   @brief Apply a high-pass filter and invert polarity
+  @note The default filter policy of FilteredPulseMonitor
  */
 class Filter {
 public:
+    //! @brief Constructor (5 Hz cutoff at 100 sps, as PulseMonitor)
+    Filter() : Filter(5.0f, 100.0f)
+    {
+    }
     /*! @brief Constructor
         @param cutoff Cutoff frequency in Hz
         @param sampling_rate Sampling rate in Hz */
@@ -71,20 +85,45 @@ public:
     {
         setSamplingRate(cutoff, sampling_rate);
     }
+    /*! @brief Constructor with the precomputed coefficient
+        @param alpha Coefficient of the high-pass filter
+        @sa coefficient() */
+    explicit Filter(const float alpha) : _alpha{alpha}
+    {
+    }
+
+    /*! @brief Coefficient of the high-pass filter
+        @param cutoff Cutoff frequency in Hz
+        @param sampling_rate Sampling rate in Hz
+        @note Can be evaluated at compile time */
+    static constexpr float coefficient(const float cutoff, const float sampling_rate)
+    {
+        // RC / (RC + dt), a single return statement for C++11 constexpr
+        return (1.0f / (2.0f * 3.14159265358979323846f * cutoff)) /
+               ((1.0f / (2.0f * 3.14159265358979323846f * cutoff)) + (1.0f / sampling_rate));
+    }
 
     /*! @brief Set the sampling rate and reset filter state
         @param cutoff Cutoff frequency in Hz
         @param sampling_rate Sampling rate in Hz */
     void setSamplingRate(const float cutoff, const float sampling_rate)
     {
-        constexpr float pi{3.14159265358979323846f};
         _cutoff       = cutoff;
         _samplingRate = sampling_rate;
+        _alpha        = coefficient(_cutoff, _samplingRate);
+        clear();
+    }
+    /*! @brief Set the sampling rate with the current cutoff and reset filter state
+        @param sampling_rate Sampling rate in Hz */
+    inline void setSamplingRate(const float sampling_rate)
+    {
+        setSamplingRate(_cutoff, sampling_rate);
+    }
+    //! @brief Reset the filter state as constructed (the coefficient is kept)
+    inline void clear()
+    {
         _prevIn = _prevOut = 0.0f;
-        auto dt            = 1.0f / _samplingRate;
-        auto RC            = 1.0f / (2.0f * pi * _cutoff);
-        _alpha             = RC / (RC + dt);
-        _ema.clear();
+        _primed            = false;
     }
 
     /*! @brief Process a sample through the filter
@@ -92,48 +131,368 @@ public:
         @return Filtered and inverted output */
     float process(const float value)
     {
-        float out = _ema.update(_alpha * (_prevOut + value - _prevIn));
-        _prevIn   = value;
-        _prevOut  = out;
+        const float out = step(_alpha, value, _prevIn, _prevOut, _primed);
+        _primed         = true;
         return -out;
     }
 
+    /*!
+      @brief A step of the high-pass filter and EMA(0.95) on the given state
+      @details For the states kept outside (e.g. the struct of arrays of PulseMonitorBank)
+      @param alpha Coefficient of the high-pass filter
+      @param value Input sample
+      @param[in,out] prevIn Previous input
+      @param[in,out] prevOut Previous output (the EMA value)
+      @param primed False on the first sample (the EMA takes it as is)
+      @return Filtered output (not inverted)
+     */
+    static inline float step(const float alpha, const float value, float& prevIn, float& prevOut, const bool primed)
+    {
+        const float hp  = alpha * (prevOut + value - prevIn);
+        const float out = primed ? 0.95f * hp + (1.0f - 0.95f) * prevOut : hp;
+        prevIn          = value;
+        prevOut         = out;
+        return out;
+    }
+
 private:
-    EMA _ema{0.95f};
     float _cutoff{}, _samplingRate{};
     float _prevIn{}, _prevOut{};
     float _alpha{};
+    bool _primed{};
 };
 
+///@cond
+namespace detail {
+// Storage of the peaks for the window, fixed by Window
+template <typename P, size_t Window>
+class PeakStorage {
+public:
+    static constexpr size_t window{Window < 3 ? 3 : Window};
+
+    explicit PeakStorage(const size_t)
+    {
+    }
+    inline FixedRing<P, window / 2 + 2>& ring()
+    {
+        return _ring;
+    }
+    inline const FixedRing<P, window / 2 + 2>& ring() const
+    {
+        return _ring;
+    }
+
+private:
+    FixedRing<P, window / 2 + 2> _ring{};
+};
+
+// Storage of the peaks for the window, allocated by the window
+template <typename P>
+class PeakStorage<P, 0> {
+public:
+    explicit PeakStorage(const size_t window) : _ring{new m5::container::CircularBuffer<P>(window / 2 + 2)}
+    {
+    }
+    inline void resize(const size_t window)
+    {
+        if (_ring->capacity() != window / 2 + 2) {
+            _ring.reset(new m5::container::CircularBuffer<P>(window / 2 + 2));
+        }
+    }
+    inline m5::container::CircularBuffer<P>& ring()
+    {
+        return *_ring;
+    }
+    inline const m5::container::CircularBuffer<P>& ring() const
+    {
+        return *_ring;
+    }
+
+private:
+    std::unique_ptr<m5::container::CircularBuffer<P>> _ring{};
+};
+}  // namespace detail
+///@endcond
+
 /*!
-  @class PulseMonitor
-  @brief Calculate BPM and SpO2, and detect the pulse beat
+  @class BasicBeatDetector
+  @brief Streaming peak detector over a sliding window
+  @details Each sample is handled in constant time, and the peaks found are the same as scanning the whole window
+  from its head every time (a peak must be preceded by a negative sample inside the window).
+  The positions of the peaks in the window are kept, so RR intervals are available without rescanning
+  @tparam T Type of the sample (float, or integer for fixed-point)
+  @tparam Window Number of samples in the window if fixed at compile time (0: given at runtime)
+  @note Storage is allocated only in the constructor and setWindow(), or none if Window is fixed
  */
-class PulseMonitor {
+template <typename T, size_t Window = 0>
+class BasicBeatDetector {
 public:
     /*!
       @brief Constructor
-      @param samplingRate sampling rate
-      @param sec Seconds of data to be stored
+      @param window Number of samples in the window (ignored if Window is fixed)
+      @param threshold Minimum value for a peak
      */
-    explicit PulseMonitor(const uint32_t samplingRate = 100, const uint32_t sec = 5)
-        : _range{sec},
-          _sampling_rate{static_cast<float>(samplingRate)},
-          _max_samples{static_cast<size_t>(samplingRate) * sec},
-          _filterIR(5.0f, samplingRate)
+    explicit BasicBeatDetector(const size_t window = Window ? Window : 500, const T threshold = T(50))
+        : _window{static_cast<uint32_t>(std::max<size_t>(Window ? Window : window, 3))},
+          _threshold{threshold},
+          _peaks(_window)
     {
-        assert(sec >= 1 && "sec must be greater or equal than 1");
-        assert(samplingRate >= 1.0f && "SamplingRate must be greater or equal than 1.0f");
     }
 
+    /*!
+      @brief Set the window size
+      @param window Number of samples in the window
+      @note Clear inner data
+      @warning Only if Window is given at runtime
+     */
+    void setWindow(const size_t window)
+    {
+        static_assert(Window == 0, "The window is fixed");
+        _window = static_cast<uint32_t>(std::max<size_t>(window, 3));
+        _peaks.resize(_window);
+        clear();
+    }
+    //! @brief Gets the window size
+    inline uint32_t window() const
+    {
+        return _window;
+    }
+    //! @brief Clear inner data
+    void clear()
+    {
+        _peaks.ring().clear();
+        _count = _negative = 0;
+        _prev[0] = _prev[1] = T{};
+        _negatived          = false;
+    }
+
+    /*!
+      @brief Push back a filtered sample
+      @param value Sample
+     */
+    void push_back(const T value)
+    {
+        auto& peaks = _peaks.ring();
+        // Judge the previous sample now that both neighbors are known
+        if (_count >= 2) {
+            const uint32_t idx = _count - 1;
+            const T v          = _prev[1];
+            if (_negatived && v > _threshold && v > _prev[0] && v > value) {
+                peaks.push_back(Peak{idx, _negative});
+                _negatived = false;
+            } else if (v < T{}) {
+                _negatived = true;
+                _negative  = idx;
+            }
+        }
+        _prev[0] = _prev[1];
+        _prev[1] = value;
+        ++_count;
+
+        // Drop the peaks that left the window
+        while (!peaks.empty() && (_count - peaks[0].index) >= _window) {
+            peaks.pop_front();
+        }
+    }
+
+    //! @brief Number of peaks in the window
+    inline size_t peaks() const
+    {
+        return _peaks.ring().size() - (excluded_head() ? 1 : 0);
+    }
+    //! @brief Is the latest judgeable sample (the one before the latest) a peak?
+    inline bool isBeat() const
+    {
+        const auto& peaks = _peaks.ring();
+        return !peaks.empty() && (_count - peaks[peaks.size() - 1].index) == 2 && this->peaks();
+    }
+    //! @brief Number of RR intervals in the window
+    inline size_t intervals() const
+    {
+        const size_t n = peaks();
+        return n ? n - 1 : 0;
+    }
+    /*!
+      @brief RR interval
+      @param i Index (0 is the oldest)
+      @return Interval in number of samples
+     */
+    inline uint32_t interval(const size_t i) const
+    {
+        assert(i < intervals() && "index overflow");
+        const auto& peaks = _peaks.ring();
+        const size_t head = peaks.size() - this->peaks();
+        return peaks[head + i + 1].index - peaks[head + i].index;
+    }
+    /*!
+      @brief Span of the RR intervals in the window
+      @return Number of samples from the oldest peak to the latest, or zero if there are not enough peaks
+      @note averageRR() is span / intervals()
+     */
+    inline uint32_t span() const
+    {
+        const size_t n = peaks();
+        if (n < 2) {
+            return 0;
+        }
+        const auto& peaks = _peaks.ring();
+        const size_t last = peaks.size() - 1;
+        return peaks[last].index - peaks[last + 1 - n].index;
+    }
+    /*!
+      @brief Average RR interval
+      @return Interval in number of samples, or zero if there are not enough peaks
+     */
+    inline float averageRR() const
+    {
+        const size_t n = intervals();
+        return n ? static_cast<float>(span()) / n : 0.0f;
+    }
+    /*!
+      @brief Calculate the BPM
+      @param sampling_rate Sampling rate
+      @return BPM, or zero if there are not enough peaks
+     */
+    inline float bpm(const float sampling_rate) const
+    {
+        const float rr = averageRR();
+        return (rr > 0.0f) ? 60.0f * sampling_rate / rr : 0.0f;
+    }
+
+private:
+    // The oldest peak is not seen from the window head unless a negative sample is in the window before it
+    inline bool excluded_head() const
+    {
+        const auto& peaks = _peaks.ring();
+        return !peaks.empty() && (_count - peaks[0].negative) >= _window;
+    }
+
+    // Aggregate (no default member initializers) for Peak{index, negative} in C++11
+    struct Peak {
+        uint32_t index;     // Sample index of the peak
+        uint32_t negative;  // Sample index of the latest negative sample before the peak
+    };
+
+    uint32_t _window{};
+    T _threshold{};
+    detail::PeakStorage<Peak, Window> _peaks;
+
+    uint32_t _count{};  // Number of samples pushed (index of the next sample)
+    uint32_t _negative{};
+    T _prev[2]{};  // [0]:2 samples ago [1]:1 sample ago
+    bool _negatived{};
+};
+
+//! @brief Beat detector for the float samples
+using BeatDetector = BasicBeatDetector<float>;
+
+/*!
+  @struct FloatSample
+  @brief Arithmetic of the samples in float
+  @details The sample policy of BasicPulseMonitor, which gives the types of the chain and the SpO2 math, so the same
+  chain runs in float or in fixed-point (FixedSample)
+ */
+struct FloatSample {
+    using input_type = float;  //!< @brief Raw sample
+    using value_type = float;  //!< @brief Filtered sample
+    using dc_type    = float;  //!< @brief DC of the raw samples
+    using sum_type   = float;  //!< @brief Squared deviation and the sum of them
+    using ratio_type = float;  //!< @brief Ratio R of Red to IR
+    using spo2_type  = float;  //!< @brief SpO2
+
+    //! @brief Minimum value for a peak
+    static constexpr value_type threshold()
+    {
+        return 50.0f;
+    }
+    //! @brief Value as float
+    static inline float to_float(const float v)
+    {
+        return v;
+    }
+    //! @brief Sample i of the n - 1 samples between prev and next (linear interpolation)
+    static inline input_type interpolate(const input_type prev, const input_type next, const uint32_t i,
+                                         const uint32_t n)
+    {
+        const float t = static_cast<float>(i) / n;
+        return prev + (next - prev) * t;
+    }
+    //! @brief Update the DC (EMA(0.95)) with the raw sample
+    static inline void average(dc_type& ave, const input_type v)
+    {
+        ave = ave * 0.95f + v * (1.0f - 0.95f);
+    }
+    //! @brief Squared deviation of the raw sample from the DC
+    static inline sum_type deviation(const input_type v, const dc_type ave)
+    {
+        return (v - ave) * (v - ave);
+    }
+    /*!
+      @brief R from the sums of the squared deviations (RMS) and the DC
+      @return True if R is available
+     */
+    static inline bool rms_ratio(const sum_type sumred, const sum_type sumir, const dc_type avered,
+                                 const dc_type aveir, ratio_type& R)
+    {
+        const float eps = 1e-6f;
+        if (std::fabs(avered) < eps || std::fabs(aveir) < eps) {
+            return false;
+        }
+        R = (std::sqrt(sumred) / avered) / (std::sqrt(sumir) / aveir);
+        return true;
+    }
+    /*!
+      @brief R from the peak-to-peak (AC) and the DC
+      @return True if R is available
+     */
+    static inline bool peak_ratio(const input_type acred, const input_type acir, const dc_type avered,
+                                  const dc_type aveir, ratio_type& R)
+    {
+        const float eps = 1e-6f;
+        if (acir < eps || std::fabs(avered) < eps || std::fabs(aveir) < eps) {
+            return false;
+        }
+        R = (acred / avered) / (acir / aveir);
+        return true;
+    }
+    //! @brief SpO2 from R
+    static inline spo2_type spo2(const ratio_type R)
+    {
+        // Empirical SpO2 approximation from the red/IR AC to DC ratio.
+        return std::fmax(std::fmin(100.0f, -23.3f * (R - 0.4f) + 100), 80.0f);  // clamp 80-100
+    }
+};
+
+/*!
+  @class BasicPulseMonitor
+  @brief Common part of PulseMonitor and PulseMonitorT
+  @tparam Derived Derived class that gives samplingRate()
+  @tparam Detector Beat detector
+  @tparam FilterPolicy Filter of IR (process() returns the filtered and inverted value, clear() resets the state)
+  @tparam Sample Arithmetic of the samples (FloatSample, or FixedSample for fixed-point)
+  @note bpm() memoizes the value, so reading a shared instance from multiple threads needs a lock
+ */
+template <class Derived, class Detector, class FilterPolicy = Filter, class Sample = FloatSample>
+class BasicPulseMonitor {
+public:
+    using input_type = typename Sample::input_type;  //!< @brief Raw sample
+    using value_type = typename Sample::value_type;  //!< @brief Filtered sample
+
     //! @brief Detect beat?
     inline bool isBeat() const
     {
         return _beat;
     }
-    //! @brief Gets the BPM
+    /*!
+      @brief Gets the BPM
+      @note Calculated on the first call after update() with new samples, and memoized until the next one
+     */
     inline float bpm() const
     {
+        if (_dirty) {
+            _bpm   = calculate_bpm();
+            _dirty = false;
+        }
         return _bpm;
     }
     /*!
@@ -142,64 +501,682 @@ public:
     */
     inline float SpO2() const
     {
-        return _spo2;
+        return Sample::to_float(_spo2);
     }
 
-    /*!
-      @brief Set the sampling rate
-      @param samplingRate sampling rate
-      @note clear stored data
-     */
-    void setSamplingRate(const uint32_t samplingRate);
-
     /*!
       @brief Push back IR
       @param ir IR data
      */
-    void push_back(const float ir);
+    inline void push_back(const input_type ir)
+    {
+        if (_gap) {
+            fill_gap(ir, input_type{}, false);
+        }
+        push_ir(ir);
+        _prev_ir = ir;
+    }
     /*!
       @brief Push back IR and RED
       @param ir IR data
       @param red RED data
       @note Calculate SpO2
      */
-    void push_back(const float ir, const float red);
+    inline void push_back(const input_type ir, const input_type red)
+    {
+        if (_gap) {
+            fill_gap(ir, red, true);
+        }
+        push_ir_red(ir, red);
+        _prev_ir  = ir;
+        _prev_red = red;
+    }
+    /*!
+      @brief Push back the samples in bulk
+      @tparam Range Iterable range of the samples (e.g. retrievedData() of the units)
+      @param range Samples (oldest first)
+      @note Elements that have ir() and red() are pushed as IR and RED, the others are pushed as IR
+      @note Same as pushing back each element, so update() afterwards (isBeat() is for the latest sample)
+     */
+    template <class Range, typename std::enable_if<!std::is_arithmetic<Range>::value, std::nullptr_t>::type = nullptr,
+              typename = decltype(std::begin(std::declval<const Range&>()))>
+    void push_back(const Range& range)
+    {
+        for (auto&& e : range) {
+            push_element(e, 0);
+        }
+    }
+
+    ///@name Gap of the samples
+    ///@{
+    /*!
+      @brief Mark the samples lost before the next sample
+      @details The next push_back() fills the lost samples by the linear interpolation between the previous and the
+      next sample, so that the time axis (BPM and the beat intervals) stays right.
+      If the gap is longer than maxGap(), the inner data is cleared instead, since the beats in it cannot be restored
+      @param lost Number of the lost samples (e.g. gap() of the units)
+     */
+    void markGap(const uint32_t lost)
+    {
+        if (!lost) {
+            return;
+        }
+        _gap += lost;
+        if (_gap > _max_gap * derived().samplingRate()) {
+            M5_LIB_LOGD("Gap of %u samples, cleared", _gap);
+            clear();
+        }
+    }
+    /*!
+      @brief Set the longest gap to be interpolated
+      @param sec Seconds (default 0.2 sec, shorter than a beat at 220 BPM)
+     */
+    inline void setMaxGap(const float sec)
+    {
+        _max_gap = std::fmax(sec, 0.0f);
+    }
+    //! @brief Longest gap to be interpolated (sec)
+    inline float maxGap() const
+    {
+        return _max_gap;
+    }
+    ///@}
+
+    /*!
+      @brief Process a block of samples
+      @details Same as push_back() and update() for each sample, but BPM is calculated once for the block
+      @param ir IR data [n]
+      @param red RED data [n] (nullptr: IR only, SpO2 is not calculated)
+      @param n Number of the samples
+      @param[out] beats Beat flags of each sample [n] (nullptr: not needed), same as isBeat() after each sample
+      @return Number of the beats in the block
+     */
+    size_t process(const input_type* ir, const input_type* red, const size_t n, bool* beats = nullptr)
+    {
+        size_t count{};
+        for (size_t i = 0; i < n; ++i) {
+            if (red) {
+                push_back(ir[i], red[i]);
+            } else {
+                push_back(ir[i]);
+            }
+            const bool beat = _detector.isBeat();
+            count += beat;
+            if (beats) {
+                beats[i] = beat;
+            }
+        }
+        update();
+        return count;
+    }
+
+    ///@name SpO2 sliding window
+    ///@{
+    /*!
+      @brief Enable the sliding window for SpO2
+      @details SpO2 is calculated from the RMS over the latest window samples, kept by running sums
+      (a sample is added and the oldest is removed), and updated every cadence samples or at each beat.
+      Without it, SpO2 is calculated over 1 sec blocks (samplingRate() samples) and updated every block
+      @param window Number of samples of the window
+      @param cadence Update SpO2 every cadence samples (0: at each beat)
+      @return True if successful
+      @note Allocates the window (heap), and clears the SpO2 state
+     */
+    bool enableSlidingSpO2(const uint32_t window, const uint32_t cadence)
+    {
+        if (!window) {
+            M5_LIB_LOGE("window must be greater or equal than 1");
+            return false;
+        }
+        if (window != _spo2_window || !_spo2_sums) {
+            _spo2_sums.reset(new sum_type[window * 2]);
+            if (!_spo2_sums) {
+                M5_LIB_LOGE("Failed to allocate");
+                _spo2_ratios.reset();
+                _spo2_window = _spo2_beats = 0;
+                return false;
+            }
+        }
+        _spo2_ratios.reset();
+        _spo2_beats   = 0;
+        _spo2_window  = window;
+        _spo2_cadence = cadence;
+        clear_spo2();
+        return true;
+    }
+    //! @brief Disable the sliding window for SpO2 (1 sec blocks)
+    void disableSlidingSpO2()
+    {
+        if (_spo2_window) {
+            _spo2_sums.reset();
+            _spo2_window = _spo2_cadence = 0;
+            clear_spo2();
+        }
+    }
+    //! @brief Is the sliding window for SpO2 enabled?
+    inline bool inSlidingSpO2() const
+    {
+        return _spo2_window != 0;
+    }
+    ///@}
+
+    ///@name SpO2 beat-synchronous
+    ///@{
+    /*!
+      @brief Enable the beat-synchronous SpO2
+      @details The AC of Red and IR is taken from the peak and valley between the detected beats, R is calculated
+      per beat, and SpO2 is updated at each beat from the average R of the latest beats.
+      The cycle is aligned to the heart beat, so SpO2 is steadier than the 1 sec blocks at low heart rates
+      @param beats Number of beats to be averaged
+      @return True if successful
+      @note Allocates R of the beats (heap). Disables the sliding window, and clears the SpO2 state
+     */
+    bool enableBeatSpO2(const uint32_t beats)
+    {
+        if (!beats) {
+            M5_LIB_LOGE("beats must be greater or equal than 1");
+            return false;
+        }
+        if (beats != _spo2_beats || !_spo2_ratios) {
+            _spo2_ratios.reset(new ratio_type[beats]);
+            if (!_spo2_ratios) {
+                M5_LIB_LOGE("Failed to allocate");
+                _spo2_sums.reset();
+                _spo2_window = _spo2_beats = 0;
+                return false;
+            }
+        }
+        _spo2_sums.reset();
+        _spo2_window = _spo2_cadence = 0;
+        _spo2_beats                  = beats;
+        clear_spo2();
+        return true;
+    }
+    //! @brief Disable the beat-synchronous SpO2 (1 sec blocks)
+    void disableBeatSpO2()
+    {
+        if (_spo2_beats) {
+            _spo2_ratios.reset();
+            _spo2_beats = 0;
+            clear_spo2();
+        }
+    }
+    //! @brief Is the beat-synchronous SpO2 enabled?
+    inline bool inBeatSpO2() const
+    {
+        return _spo2_beats != 0;
+    }
+    ///@}
+
+    ///@name BPM by the Goertzel bank
+    ///@{
+    /*!
+      @brief Enable BPM from the dominant frequency by the Goertzel bank
+      @details bpm() is estimated from the spectrum of the window (40 - 220 BPM) instead of counting the peaks,
+      which works on the low perfusion signals. The per-sample cost is only to store the sample, and the bank is
+      calculated at the refresh rate. isBeat() is still by the peaks
+      @param refresh Refresh rate in Hz
+      @return True if successful
+      @note Allocates the window and the bank (heap). Disables BPM by the autocorrelation
+     */
+    bool enableGoertzelBPM(const float refresh = 4.0f)
+    {
+        if (!(refresh > 0.0f)) {
+            M5_LIB_LOGE("refresh must be greater than zero");
+            return false;
+        }
+        _autocorr.reset();
+        _refresh = refresh;
+        if (!_goertzel) {
+            _goertzel.reset(new GoertzelBPM(derived().samplingRate(), _detector.window(), refresh_cadence()));
+            if (!_goertzel || !_goertzel->window()) {
+                _goertzel.reset();
+                return false;
+            }
+            return true;
+        }
+        return setup_estimator();
+    }
+    //! @brief Disable BPM by the Goertzel bank (count the peaks)
+    void disableGoertzelBPM()
+    {
+        _goertzel.reset();
+        _estimated = 0.0f;
+        _dirty     = true;
+    }
+    //! @brief Is BPM by the Goertzel bank enabled?
+    inline bool inGoertzelBPM() const
+    {
+        return static_cast<bool>(_goertzel);
+    }
+    ///@}
+
+    ///@name BPM by the autocorrelation
+    ///@{
+    /*!
+      @brief Enable BPM from the autocorrelation
+      @details bpm() is estimated from the lag of the autocorrelation peak over the window (40 - 220 BPM) instead
+      of counting the peaks. The lag products are updated incrementally, O(lags) per sample, and the peak is
+      searched when bpm() is called. isBeat() is still by the peaks
+      @return True if successful
+      @note Allocates the window and the lags (heap). Disables BPM by the Goertzel bank
+      @warning The window (sec) must be longer than 1.5 sec (the lag of 40 BPM)
+     */
+    bool enableAutocorrelationBPM()
+    {
+        _goertzel.reset();
+        if (!_autocorr) {
+            _autocorr.reset(new AutocorrelationBPM(derived().samplingRate(), _detector.window()));
+            if (!_autocorr || !_autocorr->window()) {
+                _autocorr.reset();
+                return false;
+            }
+            return true;
+        }
+        return setup_estimator();
+    }
+    //! @brief Disable BPM by the autocorrelation (count the peaks)
+    void disableAutocorrelationBPM()
+    {
+        _autocorr.reset();
+        _dirty = true;
+    }
+    //! @brief Is BPM by the autocorrelation enabled?
+    inline bool inAutocorrelationBPM() const
+    {
+        return static_cast<bool>(_autocorr);
+    }
+    ///@}
 
     /*!
       @brief Update status
-      @note Calculate BPM
+      @note Takes the state of the samples pushed so far. Nothing to do if no new samples
+      @note BPM is calculated when bpm() is called
      */
-    void update();
+    inline void update()
+    {
+        if (_pushed) {
+            _pushed    = false;
+            _beat      = _detector.isBeat();
+            _span      = _detector.span();
+            _intervals = static_cast<uint32_t>(_detector.intervals());
+            _estimated = _goertzel ? _goertzel->bpm() : 0.0f;
+            _dirty     = true;
+        }
+    }
 
     //! @brief Clear inner data
-    void clear();
+    void clear()
+    {
+        _filterIR.clear();
+        _detector.clear();
+        _latest  = value_type{};
+        _prev_ir = _prev_red = input_type{};
+        _primed = _beat = _pushed = _dirty = false;
+        _span = _intervals = _gap = 0;
+        _bpm = _estimated = 0.0f;
+        if (_goertzel) {
+            _goertzel->clear();
+        }
+        if (_autocorr) {
+            _autocorr->clear();
+        }
+        clear_spo2();
+    }
 
     //! @brief Filtered latest ir value
     inline float latestIR() const
     {
-        return !_dataIR.empty() ? _dataIR.back() : std::numeric_limits<float>::quiet_NaN();
+        return _primed ? Sample::to_float(_latest) : std::numeric_limits<float>::quiet_NaN();
     }
 
 protected:
-    float calculate_bpm();
+    using dc_type    = typename Sample::dc_type;
+    using sum_type   = typename Sample::sum_type;
+    using ratio_type = typename Sample::ratio_type;
+    using spo2_type  = typename Sample::spo2_type;
 
-private:
-    uint32_t _range{};  // Sec.
-    float _sampling_rate{};
-    size_t _max_samples{};
+    template <typename... Args>
+    BasicPulseMonitor(const FilterPolicy& filter, Args&&... args)
+        : _filterIR{filter}, _detector(std::forward<Args>(args)...)
+    {
+    }
+
+    inline const Derived& derived() const
+    {
+        return *static_cast<const Derived*>(this);
+    }
+
+    void clear_spo2()
+    {
+        _spo2   = spo2_type{};
+        _count  = 0;
+        _avered = _aveir = dc_type{};
+        _sumredrms = _sumirrms = sum_type{};
+        _spo2_pos = _spo2_since = 0;
+        _spo2_full              = false;
+        _cycle                  = false;
+    }
+
+    void store_spo2(const sum_type sumredrms, const sum_type sumirrms)
+    {
+        ratio_type R{};
+        if (Sample::rms_ratio(sumredrms, sumirrms, _avered, _aveir, R)) {
+            _spo2 = Sample::spo2(R);
+        }
+    }
+
+    void push_spo2_beat(const input_type ir, const input_type red)
+    {
+        if (_cycle) {
+            _maxred = std::max(_maxred, red);
+            _minred = std::min(_minred, red);
+            _maxir  = std::max(_maxir, ir);
+            _minir  = std::min(_minir, ir);
+        }
+        if (!_detector.isBeat()) {
+            return;
+        }
+        // The first beat starts the cycle
+        ratio_type* ratio = _spo2_ratios.get();
+        if (_cycle && Sample::peak_ratio(_maxred - _minred, _maxir - _minir, _avered, _aveir, ratio[_spo2_pos])) {
+            _spo2_pos        = (_spo2_pos + 1 < _spo2_beats) ? _spo2_pos + 1 : 0;
+            _spo2_full       = _spo2_full || _spo2_pos == 0;
+            const uint32_t n = _spo2_full ? _spo2_beats : _spo2_pos;
+            ratio_type R{};
+            for (uint32_t i = 0; i < n; ++i) {
+                R += ratio[i];
+            }
+            _spo2 = Sample::spo2(R / n);
+        }
+        // The beat sample is the valley (raw) of the both cycles
+        _cycle  = true;
+        _maxred = _minred = red;
+        _maxir  = _minir = ir;
+    }
+
+    void push_spo2_window(const sum_type dr, const sum_type di)
+    {
+        sum_type* red = _spo2_sums.get();
+        sum_type* ir  = red + _spo2_window;
+        if (_spo2_full) {
+            _sumredrms -= red[_spo2_pos];
+            _sumirrms -= ir[_spo2_pos];
+        }
+        red[_spo2_pos] = dr;
+        ir[_spo2_pos]  = di;
+        _sumredrms += dr;
+        _sumirrms += di;
+        if (++_spo2_pos == _spo2_window) {
+            _spo2_pos  = 0;
+            _spo2_full = true;
+            // Sum up again once per window, so that the rounding errors of the running sums do not accumulate
+            _sumredrms = _sumirrms = sum_type{};
+            for (uint32_t i = 0; i < _spo2_window; ++i) {
+                _sumredrms += red[i];
+                _sumirrms += ir[i];
+            }
+        }
+        ++_spo2_since;
+        const bool due = _spo2_cadence ? (_spo2_since >= _spo2_cadence) : _detector.isBeat();
+        if (_spo2_full && due) {
+            store_spo2(std::max(_sumredrms, sum_type{}), std::max(_sumirrms, sum_type{}));
+            _spo2_since = 0;
+        }
+    }
+
+    // 60 * rate / (span / intervals) at the latest update()
+    inline float calculate_bpm() const
+    {
+        if (_goertzel) {
+            return _estimated;
+        }
+        if (_autocorr) {
+            return _autocorr->bpm();
+        }
+        return _span ? 60.0f * derived().samplingRate() * _intervals / _span : 0.0f;
+    }
 
-    Filter _filterIR{0.5f, 100.f};
-    std::deque<float> _dataIR;
+    inline uint32_t refresh_cadence() const
+    {
+        return std::max<uint32_t>(static_cast<uint32_t>(derived().samplingRate() / _refresh + 0.5f), 1);
+    }
+    // For the sampling rate and the window
+    bool setup_estimator()
+    {
+        if (_autocorr) {
+            return _autocorr->setup(derived().samplingRate(), _detector.window());
+        }
+        return !_goertzel || _goertzel->setup(derived().samplingRate(), _detector.window(), refresh_cadence());
+    }
+
+    inline void push_ir(const input_type ir)
+    {
+        _latest = _filterIR.process(ir);
+        _detector.push_back(_latest);
+        if (_goertzel) {
+            _goertzel->push_back(Sample::to_float(_latest));
+        } else if (_autocorr) {
+            _autocorr->push_back(Sample::to_float(_latest));
+        }
+        _pushed = _primed = true;
+    }
+
+    void push_ir_red(const input_type ir, const input_type red)
+    {
+        push_ir(ir);
 
+        // For SpO2 (each second, the sliding window or each beat)
+        Sample::average(_avered, red);
+        Sample::average(_aveir, ir);
+        if (_spo2_beats) {
+            push_spo2_beat(ir, red);
+            return;
+        }
+        const sum_type dr = Sample::deviation(red, _avered);
+        const sum_type di = Sample::deviation(ir, _aveir);
+        if (_spo2_window) {
+            push_spo2_window(dr, di);
+            return;
+        }
+        _sumredrms += dr;
+        _sumirrms += di;
+        if (++_count == derived().samplingRate()) {
+            store_spo2(_sumredrms, _sumirrms);
+            _sumredrms = _sumirrms = sum_type{};
+            _count                 = 0;
+        }
+    }
+
+    // Fill the lost samples by the linear interpolation from the previous sample to the next (ir, red)
+    void fill_gap(const input_type ir, const input_type red, const bool with_red)
+    {
+        const uint32_t lost = _gap;
+        _gap                = 0;
+        if (!_primed) {
+            return;  // Nothing to interpolate from
+        }
+        for (uint32_t i = 1; i <= lost; ++i) {
+            const input_type vi = Sample::interpolate(_prev_ir, ir, i, lost + 1);
+            if (with_red) {
+                push_ir_red(vi, Sample::interpolate(_prev_red, red, i, lost + 1));
+            } else {
+                push_ir(vi);
+            }
+        }
+    }
+
+    template <typename T>
+    inline auto push_element(const T& e, int) -> decltype(e.ir(), e.red(), void())
+    {
+        push_back(static_cast<input_type>(e.ir()), static_cast<input_type>(e.red()));
+    }
+    template <typename T>
+    inline void push_element(const T& e, long)
+    {
+        push_back(static_cast<input_type>(e));
+    }
+
+    FilterPolicy _filterIR;
+    Detector _detector;
+    value_type _latest{};  // Filtered latest IR
+    bool _primed{};        // Pushed since clear()
+
+    // Gap of the samples
+    uint32_t _gap{};  // Lost samples before the next sample
+    float _max_gap{0.2f};
+    input_type _prev_ir{}, _prev_red{};  // Raw previous sample
+
+    bool _pushed{};  // New samples since the latest update()
     bool _beat{};
-    float _bpm{};
-    float _spo2{};
+    uint32_t _span{}, _intervals{};
+    mutable bool _dirty{};  // _bpm is not calculated for the latest update()
+    mutable float _bpm{};
+    spo2_type _spo2{};
+
+    // BPM estimator
+    std::unique_ptr<GoertzelBPM> _goertzel{};
+    std::unique_ptr<AutocorrelationBPM> _autocorr{};
+    float _refresh{};
+    float _estimated{};  // BPM of the estimator at the latest update()
 
     uint32_t _count{};
-    float _avered{}, _aveir{};
-    float _sumredrms{}, _sumirrms{};
+    dc_type _avered{}, _aveir{};
+    sum_type _sumredrms{}, _sumirrms{};
+
+    // SpO2 sliding window or beat-synchronous
+    std::unique_ptr<sum_type[]> _spo2_sums{};      // Squared deviations [0 ... window - 1]:Red [window ...]:IR
+    std::unique_ptr<ratio_type[]> _spo2_ratios{};  // R of the beats
+    uint32_t _spo2_window{}, _spo2_cadence{}, _spo2_pos{}, _spo2_since{};
+    uint32_t _spo2_beats{};
+    bool _spo2_full{};
+    bool _cycle{};  // Between the beats
+    input_type _maxred{}, _minred{}, _maxir{}, _minir{};
 };
 
+/*!
+  @class FilteredPulseMonitor
+  @brief Calculate BPM and SpO2, and detect the pulse beat
+  @details The filter of IR is given as the policy, so the chain is inlined into push_back()
+  @tparam FilterPolicy Filter of IR that is default constructible, has setSamplingRate(float), process(input_type)
+  (returns the filtered and inverted value) and clear()
+  @tparam Sample Arithmetic of the samples (FloatSample, or FixedSample for fixed-point)
+  @note No heap allocation after the configuration. Storage is allocated only in the constructor, setSamplingRate()
+  and the enable functions of the optional calculations (e.g. enableSlidingSpO2()), so push_back(), update() and the
+  accessors can run for long periods without fragmenting the heap. Enable them before the samples, not in the loop
+  @sa PulseMonitor, BiquadPulseMonitor, FixedPulseMonitor
+ */
+template <class FilterPolicy, class Sample = FloatSample>
+class FilteredPulseMonitor
+    : public BasicPulseMonitor<FilteredPulseMonitor<FilterPolicy, Sample>,
+                               BasicBeatDetector<typename Sample::value_type>, FilterPolicy, Sample> {
+    using base_type = BasicPulseMonitor<FilteredPulseMonitor<FilterPolicy, Sample>,
+                                        BasicBeatDetector<typename Sample::value_type>, FilterPolicy, Sample>;
+
+public:
+    /*!
+      @brief Constructor
+      @param samplingRate sampling rate
+      @param sec Seconds of data to be stored
+      @param filter Filter of IR (configured for the sampling rate)
+     */
+    explicit FilteredPulseMonitor(const uint32_t samplingRate = 100, const uint32_t sec = 5,
+                                  const FilterPolicy& filter = FilterPolicy())
+        : base_type(configured(filter, samplingRate), static_cast<size_t>(samplingRate) * sec, Sample::threshold()),
+          _range{sec},
+          _sampling_rate{samplingRate}
+    {
+        assert(sec >= 1 && "sec must be greater or equal than 1");
+        assert(samplingRate >= 1 && "SamplingRate must be greater or equal than 1");
+    }
+
+    //! @brief Gets the sampling rate
+    inline uint32_t samplingRate() const
+    {
+        return _sampling_rate;
+    }
+    /*!
+      @brief Set the sampling rate
+      @param samplingRate sampling rate
+      @note clear stored data
+     */
+    void setSamplingRate(const uint32_t samplingRate)
+    {
+        if (!samplingRate) {
+            M5_LIB_LOGE("SamplingRate must be greater equal than 1.0f");
+            return;
+        }
+        _sampling_rate = samplingRate;
+        this->_filterIR.setSamplingRate(static_cast<float>(samplingRate));
+        this->_detector.setWindow(static_cast<size_t>(samplingRate) * _range);
+        this->setup_estimator();
+        this->clear();
+    }
+
+private:
+    static FilterPolicy configured(FilterPolicy filter, const uint32_t samplingRate)
+    {
+        filter.setSamplingRate(static_cast<float>(samplingRate));
+        return filter;
+    }
+
+    uint32_t _range{};  // Sec.
+    uint32_t _sampling_rate{};
+};
+
+///@cond
+extern template class FilteredPulseMonitor<Filter>;
+///@endcond
+
+/*!
+  @class PulseMonitor
+  @brief Calculate BPM and SpO2, and detect the pulse beat with the 5 Hz high-pass filter and EMA(0.95)
+  @sa PulseMonitorT if the sampling rate and the window are fixed
+ */
+class PulseMonitor : public FilteredPulseMonitor<Filter> {
+public:
+    using FilteredPulseMonitor<Filter>::FilteredPulseMonitor;
+};
+
+/*!
+  @typedef BiquadPulseMonitor
+  @brief PulseMonitor with the biquad band-pass and mains notch
+ */
+using BiquadPulseMonitor = FilteredPulseMonitor<BiquadFilter>;
+
+/*!
+  @class PulseMonitorT
+  @brief PulseMonitor with the sampling rate and the window fixed at compile time
+  @details The filter coefficient is constexpr and the window is std::array, so no heap and no division for the
+  settings. The results are the same as PulseMonitor(Rate, Sec)
+  @tparam Rate Sampling rate
+  @tparam Sec Seconds of the window
+ */
+template <uint32_t Rate, uint32_t Sec>
+class PulseMonitorT : public BasicPulseMonitor<PulseMonitorT<Rate, Sec>, BasicBeatDetector<float, Rate * Sec>> {
+    static_assert(Rate >= 1, "Rate must be greater or equal than 1");
+    static_assert(Sec >= 1, "Sec must be greater or equal than 1");
+
+public:
+    static constexpr float filter_coefficient{Filter::coefficient(5.0f, Rate)};  //!< @brief Filter coefficient
+
+    PulseMonitorT()
+        : BasicPulseMonitor<PulseMonitorT<Rate, Sec>, BasicBeatDetector<float, Rate * Sec>>(Filter(filter_coefficient))
+    {
+    }
+
+    //! @brief Gets the sampling rate
+    static constexpr uint32_t samplingRate()
+    {
+        return Rate;
+    }
+};
+
+///@cond
+template <uint32_t Rate, uint32_t Sec>
+constexpr float PulseMonitorT<Rate, Sec>::filter_coefficient;
+///@endcond
+
 }  // namespace heart
 }  // namespace m5
 #endif
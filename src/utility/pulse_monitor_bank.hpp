@@ -0,0 +1,325 @@
+/*
+ * SPDX-FileCopyrightText: 2026 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file pulse_monitor_bank.hpp
+  @brief Calculate BPM and SpO2 for multiple sensors at once
+*/
+#ifndef M5_UNIT_HEART_UTILITY_PULSE_MONITOR_BANK_HPP
+#define M5_UNIT_HEART_UTILITY_PULSE_MONITOR_BANK_HPP
+
+#include "pulse_monitor.hpp"
+#include <array>
+
+namespace m5 {
+namespace heart {
+
+/*!
+  @class PulseMonitorBank
+  @brief PulseMonitor for N channels (sensors) at the same sampling rate
+  @details The filter and SpO2 states are kept as struct of arrays, so that one push_back() processes a sample of
+  every channel in loops over the channels without branches, which the compiler can vectorize (SSE/AVX/NEON, and
+  the SIMD of ESP32-S3 where supported by the compiler). The beat detection is per channel.
+  The filter and SpO2 steps are those of PulseMonitor (Filter::step() and FloatSample), so the results of each
+  channel are the same as PulseMonitor
+  @tparam N Number of channels
+  @note No heap allocation after construction. Storage is allocated only in the constructor and setSamplingRate()
+ */
+template <size_t N>
+class PulseMonitorBank {
+    static_assert(N >= 1, "N must be greater or equal than 1");
+
+public:
+    /*!
+      @brief Constructor
+      @param samplingRate sampling rate
+      @param sec Seconds of data to be stored
+     */
+    explicit PulseMonitorBank(const uint32_t samplingRate = 100, const uint32_t sec = 5) : _range{sec}
+    {
+        assert(sec >= 1 && "sec must be greater or equal than 1");
+        setSamplingRate(samplingRate);
+    }
+
+    //! @brief Number of channels
+    static constexpr size_t channels()
+    {
+        return N;
+    }
+    //! @brief Gets the sampling rate
+    inline uint32_t samplingRate() const
+    {
+        return _sampling_rate;
+    }
+    /*!
+      @brief Set the sampling rate
+      @param samplingRate sampling rate
+      @note clear stored data
+     */
+    void setSamplingRate(const uint32_t samplingRate)
+    {
+        if (!samplingRate) {
+            M5_LIB_LOGE("SamplingRate must be greater equal than 1");
+            return;
+        }
+        _sampling_rate = samplingRate;
+        _alpha         = Filter::coefficient(5.0f, static_cast<float>(samplingRate));
+        for (auto&& d : _detector) {
+            d.setWindow(static_cast<size_t>(samplingRate) * _range);
+        }
+        clear();
+    }
+
+    ///@name Channel
+    ///@{
+    //! @brief Detect beat?
+    inline bool isBeat(const size_t ch) const
+    {
+        assert(ch < N && "channel overflow");
+        return _beat[ch];
+    }
+    //! @brief Gets the BPM
+    inline float bpm(const size_t ch) const
+    {
+        assert(ch < N && "channel overflow");
+        return _bpm[ch];
+    }
+    /*!
+      @brief Gets the SpO2
+      @warning IR and RED must be pushed back
+    */
+    inline float SpO2(const size_t ch) const
+    {
+        assert(ch < N && "channel overflow");
+        return _spo2[ch];
+    }
+    //! @brief Filtered latest ir value
+    inline float latestIR(const size_t ch) const
+    {
+        assert(ch < N && "channel overflow");
+        return _pushed ? -_prevOut[ch] : std::numeric_limits<float>::quiet_NaN();
+    }
+    ///@}
+
+    /*!
+      @brief Push back IR of all channels
+      @param ir IR data [N]
+     */
+    void push_back(const float* ir)
+    {
+        assert(ir && "ir must not be nullptr");
+        if (_gap) {
+            fill_gap(ir, nullptr);
+        }
+        push_ir(ir);
+    }
+    /*!
+      @brief Push back IR and RED of all channels
+      @param ir IR data [N]
+      @param red RED data [N]
+      @note Calculate SpO2
+     */
+    void push_back(const float* ir, const float* red)
+    {
+        assert(ir && red && "ir and red must not be nullptr");
+        if (_gap) {
+            fill_gap(ir, red);
+        }
+        push_ir_red(ir, red);
+    }
+
+    ///@name Gap of the samples
+    ///@{
+    /*!
+      @brief Mark the samples lost before the next sample of all channels
+      @details The next push_back() fills the lost samples by the linear interpolation between the previous and the
+      next sample. If the gap is longer than maxGap(), the inner data is cleared instead
+      @param lost Number of the lost samples (e.g. gap() of the units)
+      @sa BasicPulseMonitor::markGap()
+     */
+    void markGap(const uint32_t lost)
+    {
+        if (!lost) {
+            return;
+        }
+        _gap += lost;
+        if (_gap > _max_gap * _sampling_rate) {
+            M5_LIB_LOGD("Gap of %u samples, cleared", _gap);
+            clear();
+        }
+    }
+    /*!
+      @brief Set the longest gap to be interpolated
+      @param sec Seconds (default 0.2 sec, shorter than a beat at 220 BPM)
+     */
+    inline void setMaxGap(const float sec)
+    {
+        _max_gap = std::fmax(sec, 0.0f);
+    }
+    //! @brief Longest gap to be interpolated (sec)
+    inline float maxGap() const
+    {
+        return _max_gap;
+    }
+    ///@}
+
+    /*!
+      @brief Process a block of samples of all channels
+      @details Same as push_back() for each sample and update() once for the block
+      @param ir IR data [n][N]
+      @param red RED data [n][N] (nullptr: IR only, SpO2 is not calculated)
+      @param n Number of the samples of each channel
+      @param[out] beats Beat flags of each sample [n][N] (nullptr: not needed), same as isBeat() after each sample
+      @return Number of the beats in the block of all channels
+     */
+    size_t process(const float* ir, const float* red, const size_t n, bool* beats = nullptr)
+    {
+        size_t count{};
+        for (size_t i = 0; i < n; ++i) {
+            if (red) {
+                push_back(ir + i * N, red + i * N);
+            } else {
+                push_back(ir + i * N);
+            }
+            for (size_t ch = 0; ch < N; ++ch) {
+                const bool beat = _detector[ch].isBeat();
+                count += beat;
+                if (beats) {
+                    beats[i * N + ch] = beat;
+                }
+            }
+        }
+        update();
+        return count;
+    }
+
+    /*!
+      @brief Update status of all channels
+      @note Calculate BPM
+     */
+    void update()
+    {
+        // BPM is 60 * rate / (span / intervals), same as PulseMonitor
+        for (size_t i = 0; i < N; ++i) {
+            const uint32_t span = _detector[i].span();
+            _beat[i]            = _detector[i].isBeat();
+            _bpm[i]             = span ? 60.0f * _sampling_rate * _detector[i].intervals() / span : 0.0f;
+        }
+    }
+
+    //! @brief Clear inner data
+    void clear()
+    {
+        _primed = false;
+        _prevIn.fill(0.0f);
+        _prevOut.fill(0.0f);
+        for (auto&& d : _detector) {
+            d.clear();
+        }
+        _pushed = false;
+        _gap    = 0;
+        _beat.fill(false);
+        _bpm.fill(0.0f);
+        _spo2.fill(0.0f);
+
+        _count = 0;
+        _avered.fill(0.0f);
+        _aveir.fill(0.0f);
+        _sumredrms.fill(0.0f);
+        _sumirrms.fill(0.0f);
+    }
+
+private:
+    void push_ir(const float* ir)
+    {
+        // Filter (high-pass and EMA(0.95)) over the channels
+        float out[N];
+        for (size_t i = 0; i < N; ++i) {
+            out[i] = Filter::step(_alpha, ir[i], _prevIn[i], _prevOut[i], _primed);
+        }
+        _primed = true;
+        for (size_t i = 0; i < N; ++i) {
+            _detector[i].push_back(-out[i]);
+        }
+        _pushed = true;
+    }
+
+    void push_ir_red(const float* ir, const float* red)
+    {
+        push_ir(ir);
+
+        // For SpO2 (each second)
+        for (size_t i = 0; i < N; ++i) {
+            FloatSample::average(_avered[i], red[i]);
+            FloatSample::average(_aveir[i], ir[i]);
+            _sumredrms[i] += FloatSample::deviation(red[i], _avered[i]);
+            _sumirrms[i] += FloatSample::deviation(ir[i], _aveir[i]);
+            _prev_red[i] = red[i];
+        }
+        if (++_count == _sampling_rate) {
+            for (size_t i = 0; i < N; ++i) {
+                float R{};
+                if (FloatSample::rms_ratio(_sumredrms[i], _sumirrms[i], _avered[i], _aveir[i], R)) {
+                    _spo2[i] = FloatSample::spo2(R);
+                }
+            }
+            _sumredrms.fill(0.0f);
+            _sumirrms.fill(0.0f);
+            _count = 0;
+        }
+    }
+
+    // Fill the lost samples by the linear interpolation from the previous sample to the next (ir, red)
+    void fill_gap(const float* ir, const float* red)
+    {
+        const uint32_t lost = _gap;
+        _gap                = 0;
+        if (!_primed) {
+            return;  // Nothing to interpolate from
+        }
+        const std::array<float, N> from_ir{_prevIn}, from_red{_prev_red};
+        float vi[N], vr[N];
+        for (uint32_t k = 1; k <= lost; ++k) {
+            for (size_t i = 0; i < N; ++i) {
+                vi[i] = FloatSample::interpolate(from_ir[i], ir[i], k, lost + 1);
+            }
+            if (!red) {
+                push_ir(vi);
+                continue;
+            }
+            for (size_t i = 0; i < N; ++i) {
+                vr[i] = FloatSample::interpolate(from_red[i], red[i], k, lost + 1);
+            }
+            push_ir_red(vi, vr);
+        }
+    }
+
+    uint32_t _range{};  // Sec.
+    uint32_t _sampling_rate{};
+
+    // Filter
+    float _alpha{};
+    bool _primed{};
+    std::array<float, N> _prevIn{}, _prevOut{};  // _prevOut is also the EMA value, _prevIn the raw previous IR
+    std::array<BeatDetector, N> _detector;
+    bool _pushed{};
+
+    // Gap of the samples
+    uint32_t _gap{};  // Lost samples before the next sample
+    float _max_gap{0.2f};
+    std::array<float, N> _prev_red{};  // Raw previous RED
+
+    std::array<bool, N> _beat{};
+    std::array<float, N> _bpm{}, _spo2{};
+
+    // SpO2
+    uint32_t _count{};
+    std::array<float, N> _avered{}, _aveir{};
+    std::array<float, N> _sumredrms{}, _sumirrms{};
+};
+
+}  // namespace heart
+}  // namespace m5
+#endif
@@ -0,0 +1,129 @@
+/*
+ * SPDX-FileCopyrightText: 2026 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file span.hpp
+  @brief Non-owning view of contiguous elements
+*/
+#ifndef M5_UNIT_HEART_UTILITY_SPAN_HPP
+#define M5_UNIT_HEART_UTILITY_SPAN_HPP
+
+#include <cstddef>
+#include <cassert>
+#include <type_traits>
+
+namespace m5 {
+namespace heart {
+
+/*!
+  @class Span
+  @brief Non-owning view of contiguous elements (like std::span of C++20)
+  @tparam T Element type
+  @warning The view does not extend the lifetime of the elements
+ */
+template <typename T>
+class Span {
+public:
+    using element_type   = T;
+    using value_type     = typename std::remove_cv<T>::type;
+    using size_type      = size_t;
+    using pointer        = T*;
+    using reference      = T&;
+    using iterator       = T*;
+    using const_iterator = const T*;
+
+    //! @brief Empty view
+    constexpr Span() = default;
+    /*!
+      @brief Constructor
+      @param data Pointer to the first element
+      @param size Number of elements
+     */
+    constexpr Span(pointer data, const size_type size) : _data{data}, _size{size}
+    {
+    }
+    //! @brief View of the array
+    template <size_t N>
+    constexpr Span(element_type (&arr)[N]) : _data{arr}, _size{N}
+    {
+    }
+    //! @brief Span<T> to Span<const T>
+    template <typename U, typename std::enable_if<std::is_convertible<U (*)[], T (*)[]>::value, std::nullptr_t>::type =
+                              nullptr>
+    constexpr Span(const Span<U>& s) : _data{s.data()}, _size{s.size()}
+    {
+    }
+
+    ///@name Properties
+    ///@{
+    inline constexpr pointer data() const
+    {
+        return _data;
+    }
+    inline constexpr size_type size() const
+    {
+        return _size;
+    }
+    inline constexpr bool empty() const
+    {
+        return _size == 0;
+    }
+    ///@}
+
+    ///@name Element access
+    ///@{
+    inline reference operator[](const size_type i) const
+    {
+        assert(i < _size && "index overflow");
+        return _data[i];
+    }
+    inline reference front() const
+    {
+        assert(_size && "empty");
+        return _data[0];
+    }
+    inline reference back() const
+    {
+        assert(_size && "empty");
+        return _data[_size - 1];
+    }
+    ///@}
+
+    ///@name Iterator
+    ///@{
+    inline constexpr iterator begin() const
+    {
+        return _data;
+    }
+    inline constexpr iterator end() const
+    {
+        return _data + _size;
+    }
+    ///@}
+
+    ///@name Subview
+    ///@{
+    //! @brief The first n elements
+    inline Span first(const size_type n) const
+    {
+        assert(n <= _size && "size overflow");
+        return Span(_data, n);
+    }
+    //! @brief The last n elements
+    inline Span last(const size_type n) const
+    {
+        assert(n <= _size && "size overflow");
+        return Span(_data + _size - n, n);
+    }
+    ///@}
+
+private:
+    pointer _data{};
+    size_type _size{};
+};
+
+}  // namespace heart
+}  // namespace m5
+#endif
@@ -0,0 +1,137 @@
+/*
+ * SPDX-FileCopyrightText: 2026 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file spsc_ring.hpp
+  @brief Lock-free single-producer/single-consumer ring buffer
+*/
+#ifndef M5_UNIT_HEART_UTILITY_SPSC_RING_HPP
+#define M5_UNIT_HEART_UTILITY_SPSC_RING_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace m5 {
+namespace heart {
+
+/*!
+  @class SPSCRing
+  @brief Lock-free ring buffer between a producer and a consumer (task, thread or ISR)
+  @details The producer only writes the tail and the consumer only writes the head, and the element is published by
+  the release store of the index and taken by the acquire load, so no lock and no critical section are needed.
+  Unlike FixedRing, push() fails when full (the producer does not touch the head), and dropped() counts them
+  @tparam T Element type
+  @tparam N Capacity (power of 2)
+  @warning Only one producer and one consumer
+ */
+template <typename T, size_t N>
+class SPSCRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "N must be a power of 2");
+
+public:
+    using value_type = T;
+    using size_type  = size_t;
+
+    ///@name Properties
+    ///@{
+    inline constexpr size_type capacity() const
+    {
+        return N;
+    }
+    /*!
+      @brief Number of the elements (approximate while the other side is running)
+      @note Can be called from either side (or another thread). The head is loaded before the tail, so the head does
+      not pass the loaded tail, and the result is clamped to the capacity for the tail advanced in the meantime
+     */
+    inline size_type size() const
+    {
+        const size_t head = _head.load(std::memory_order_acquire);
+        const size_t tail = _tail.load(std::memory_order_acquire);
+        return (tail - head < N) ? tail - head : N;
+    }
+    inline bool empty() const
+    {
+        return size() == 0;
+    }
+    inline bool full() const
+    {
+        return size() == N;
+    }
+    //! @brief Number of the elements failed to push because of full
+    inline uint32_t dropped() const
+    {
+        return _dropped.load(std::memory_order_relaxed);
+    }
+    ///@}
+
+    ///@name Producer
+    ///@{
+    /*!
+      @brief Push back the element
+      @return True if pushed, false if full
+     */
+    inline bool push(const T& v)
+    {
+        const size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head.load(std::memory_order_acquire) >= N) {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        _buf[tail & (N - 1)] = v;
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+    ///@}
+
+    ///@name Consumer
+    ///@{
+    /*!
+      @brief Pop the oldest element
+      @param[out] v Element
+      @return True if popped, false if empty
+     */
+    inline bool pop(T& v)
+    {
+        const size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        v = _buf[head & (N - 1)];
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+    /*!
+      @brief Pop the elements
+      @param[out] out Destination
+      @param len Maximum number of the elements
+      @return Number of the popped elements
+     */
+    size_type pop(T* out, const size_type len)
+    {
+        const size_t head = _head.load(std::memory_order_relaxed);
+        const size_t tail = _tail.load(std::memory_order_acquire);
+        size_type cnt     = 0;
+        while (cnt < len && head + cnt != tail) {
+            out[cnt] = _buf[(head + cnt) & (N - 1)];
+            ++cnt;
+        }
+        _head.store(head + cnt, std::memory_order_release);
+        return cnt;
+    }
+    ///@}
+
+private:
+    std::array<T, N> _buf{};
+    // The indexes are not wrapped, the difference is the size (unsigned overflow is well-defined)
+    std::atomic<size_t> _head{0};  // Written by the consumer
+    std::atomic<size_t> _tail{0};  // Written by the producer
+    std::atomic<uint32_t> _dropped{0};
+};
+
+}  // namespace heart
+}  // namespace m5
+#endif
@@ -0,0 +1,72 @@
+/*
+ * SPDX-FileCopyrightText: 2026 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  Helper for native benchmarks
+*/
+#ifndef M5_UNIT_HEART_TEST_NATIVE_BENCH_HELPER_HPP
+#define M5_UNIT_HEART_TEST_NATIVE_BENCH_HELPER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+
+namespace m5 {
+namespace heart {
+namespace test {
+
+struct BenchResult {
+    double ns_per_sample{};
+    double samples_per_sec{};
+};
+
+// Keep the compiler from discarding the benchmarked work
+template <typename T>
+inline void do_not_optimize(const T& v)
+{
+    asm volatile("" : : "r,m"(v) : "memory");
+}
+
+/*!
+  @brief Measure the cost per sample
+  @param samples Number of samples processed by a call of func
+  @param func Function to be measured
+  @param repeat Number of measurements (the fastest is adopted)
+ */
+template <typename F>
+BenchResult bench(const size_t samples, F&& func, const uint32_t repeat = 5)
+{
+    using clock = std::chrono::steady_clock;
+    func();  // Warm up
+    double best{1e300};
+    for (uint32_t i = 0; i < repeat; ++i) {
+        auto start = clock::now();
+        func();
+        auto ns = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+        best    = std::min(best, ns);
+    }
+    BenchResult r{};
+    r.ns_per_sample   = best / samples;
+    r.samples_per_sec = r.ns_per_sample > 0.0 ? 1e9 / r.ns_per_sample : 0.0;
+    return r;
+}
+
+inline void print_result(const char* name, const BenchResult& r)
+{
+    std::printf("[BENCH] %-48s %10.2f ns/sample %14.0f samples/sec\n", name, r.ns_per_sample, r.samples_per_sec);
+}
+
+// Bus traffic per sample on the mock bus
+inline void print_bus(const char* name, const double transactions_per_sample, const double wire_bytes_per_sample)
+{
+    std::printf("[BUS]   %-48s %10.3f trans/sample %10.3f wire bytes/sample\n", name, transactions_per_sample,
+                wire_bytes_per_sample);
+}
+
+}  // namespace test
+}  // namespace heart
+}  // namespace m5
+#endif
@@ -0,0 +1,75 @@
+/*
+ * SPDX-FileCopyrightText: 2026 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  Former PulseMonitor BPM calculation, as the reference of native tests and benchmarks
+*/
+#ifndef M5_UNIT_HEART_TEST_NATIVE_LEGACY_PULSE_MONITOR_HPP
+#define M5_UNIT_HEART_TEST_NATIVE_LEGACY_PULSE_MONITOR_HPP
+
+#include <utility/pulse_monitor.hpp>
+#include <deque>
+#include <vector>
+
+namespace m5 {
+namespace heart {
+namespace test {
+
+// Former implementation that rescans the whole window on each update
+class LegacyMonitor {
+public:
+    LegacyMonitor(const uint32_t rate, const uint32_t sec)
+        : _sampling_rate{static_cast<float>(rate)}, _max_samples{rate * sec}, _filter(5.0f, rate)
+    {
+    }
+
+    void push_back(const float ir)
+    {
+        _data.push_back(_filter.process(ir));
+        if (_data.size() > _max_samples) {
+            _data.pop_front();
+        }
+    }
+
+    void update()
+    {
+        _beat = false;
+        _bpm  = 0.0f;
+        if (_data.size() < 3) {
+            return;
+        }
+        std::vector<uint32_t> peaks;
+        bool negatived{};
+        for (uint32_t i = 1; i < _data.size() - 1; ++i) {
+            if (negatived && (_data[i] > 50.f) && _data[i] > _data[i - 1] && _data[i] > _data[i + 1]) {
+                peaks.push_back(i);
+                negatived = false;
+                _beat     = (i == (_data.size() - 2));
+            } else if (!negatived && _data[i] < 0.0f) {
+                negatived = true;
+            }
+        }
+        if (peaks.size() < 2) {
+            return;
+        }
+        float isum{};
+        for (size_t i = 1; i < peaks.size(); ++i) {
+            isum += (peaks[i] - peaks[i - 1]) / _sampling_rate;
+        }
+        _bpm = 60.0f / (isum / (peaks.size() - 1));
+    }
+
+    float _sampling_rate{};
+    size_t _max_samples{};
+    Filter _filter;
+    std::deque<float> _data;
+    bool _beat{};
+    float _bpm{};
+};
+
+}  // namespace test
+}  // namespace heart
+}  // namespace m5
+#endif
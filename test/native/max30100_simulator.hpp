@@ -0,0 +1,301 @@
+/*
+ * SPDX-FileCopyrightText: 2026 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  Register-level MAX30100 model on the mock I2C bus
+  Samples are generated at the configured rate as the virtual time advances
+*/
+#ifndef M5_UNIT_HEART_TEST_NATIVE_MAX30100_SIMULATOR_HPP
+#define M5_UNIT_HEART_TEST_NATIVE_MAX30100_SIMULATOR_HPP
+
+#include "mock_i2c.hpp"
+#include "synthetic_ppg.hpp"
+#include <cmath>
+
+namespace m5 {
+namespace heart {
+namespace test {
+
+/*!
+  @class MAX30100Simulator
+  @brief MAX30100 registers, 16-deep FIFO, overflow counter, interrupt status and die temperature
+  @note Register auto-increment stops at FIFO_DATA, which pops the FIFO byte by byte
+  @note No roll over on MAX30100; samples are lost while the FIFO is full
+ */
+class MAX30100Simulator : public RegisterDevice {
+public:
+    static constexpr uint8_t FIFO_DEPTH{16};
+    static constexpr uint8_t SAMPLE_BYTES{4};  // IR[15:8] IR[7:0] RED[15:8] RED[7:0] even in HR mode
+
+    /*!
+      @brief Sample generator
+      @param index Sample index since the measurement started
+      @param rate Output rate of the FIFO
+      @param led LED (1:Red 2:IR)
+      @return 16 bits ADC value
+     */
+    using Generator = uint32_t (*)(const uint32_t index, const uint32_t rate, const uint8_t led, void* arg);
+
+    MAX30100Simulator()
+    {
+        _params.max_value = 0xFFFF;
+        powerOnReset();
+    }
+
+    //! @brief Power on reset
+    void powerOnReset()
+    {
+        std::memset(_reg, 0x00, sizeof(_reg));
+        _reg[PART_ID]     = 0x11;
+        _reg[REVISION_ID] = 0x05;
+        _reg[INT_STATUS] |= INT_PWR_RDY;
+        _ptr = _rbyte = 0;
+        _full         = false;
+        _acc          = 0;
+    }
+
+    ///@name Virtual time
+    ///@{
+    //! @brief Advance the virtual time and generate the samples in the meantime
+    void advance(const uint32_t us)
+    {
+        _now += us;
+        const uint32_t rate = samplingRate();
+        if (!rate) {
+            _acc = 0;
+            return;
+        }
+        _acc += static_cast<uint64_t>(us) * rate;
+        while (_acc >= 1000000ULL) {
+            _acc -= 1000000ULL;
+            generate(rate);
+        }
+    }
+    virtual uint64_t now() const override
+    {
+        return _now;
+    }
+    ///@}
+
+    //! @brief FIFO output rate (0 if not sampling)
+    inline uint32_t samplingRate() const
+    {
+        constexpr uint32_t table[] = {50, 100, 167, 200, 400, 600, 800, 1000};
+        const uint8_t mode = _reg[MODE_CONFIG] & 0x07;
+        return ((mode == 0x02 || mode == 0x03) && !(_reg[MODE_CONFIG] & 0x80)) ? table[(_reg[SPO2_CONFIG] >> 2) & 0x07]
+                                                                                : 0;
+    }
+    //! @brief Number of unread samples
+    inline uint8_t unread() const
+    {
+        return _full ? FIFO_DEPTH : static_cast<uint8_t>((_reg[FIFO_WR_PTR] - _reg[FIFO_RD_PTR]) & (FIFO_DEPTH - 1));
+    }
+    //! @brief Number of samples generated
+    inline uint32_t generated() const
+    {
+        return _generated;
+    }
+    //! @brief Number of samples lost by overflow in total (the register saturates, this does not)
+    inline uint32_t lost() const
+    {
+        return _lost;
+    }
+    //! @brief INT pin (active low) is asserted?
+    inline bool interrupt() const
+    {
+        return _reg[INT_STATUS] & _reg[INT_ENABLE];
+    }
+    //! @brief Register value without side effects
+    inline uint8_t peek(const uint8_t reg) const
+    {
+        return _reg[reg];
+    }
+
+    //! @brief Replace the generator (nullptr:synthetic PPG)
+    inline void setGenerator(Generator gen, void* arg = nullptr)
+    {
+        _gen = gen;
+        _arg = arg;
+    }
+    inline void setPPGParams(const PPGParams& p)
+    {
+        _params = p;
+    }
+    //! @brief Die temperature (Celsius)
+    inline void setTemperature(const float c)
+    {
+        _temperature = c;
+    }
+
+    virtual bool write(const uint8_t* data, const size_t len) override
+    {
+        if (!len) {
+            return true;
+        }
+        _ptr = data[0];
+        for (size_t i = 1; i < len; ++i) {
+            write_register(_ptr, data[i]);
+            if (_ptr != FIFO_DATA) {
+                ++_ptr;
+            }
+        }
+        return true;
+    }
+
+    virtual bool read(uint8_t* buf, const size_t len) override
+    {
+        for (size_t i = 0; i < len; ++i) {
+            if (_ptr == FIFO_DATA) {
+                buf[i] = pop_byte();
+                continue;
+            }
+            buf[i] = _reg[_ptr];
+            if (_ptr == INT_STATUS) {
+                _reg[_ptr] = 0;  // Cleared by reading
+            }
+            ++_ptr;
+        }
+        return true;
+    }
+
+    // Registers
+    static constexpr uint8_t INT_STATUS{0x00};
+    static constexpr uint8_t INT_ENABLE{0x01};
+    static constexpr uint8_t FIFO_WR_PTR{0x02};
+    static constexpr uint8_t OVF_COUNTER{0x03};
+    static constexpr uint8_t FIFO_RD_PTR{0x04};
+    static constexpr uint8_t FIFO_DATA{0x05};
+    static constexpr uint8_t MODE_CONFIG{0x06};
+    static constexpr uint8_t SPO2_CONFIG{0x07};
+    static constexpr uint8_t LED_CONFIG{0x09};
+    static constexpr uint8_t TEMP_INT{0x16};
+    static constexpr uint8_t TEMP_FRAC{0x17};
+    static constexpr uint8_t REVISION_ID{0xFE};
+    static constexpr uint8_t PART_ID{0xFF};
+    // Interrupt bits
+    static constexpr uint8_t INT_A_FULL{0x80};
+    static constexpr uint8_t INT_TEMP_RDY{0x40};
+    static constexpr uint8_t INT_HR_RDY{0x20};
+    static constexpr uint8_t INT_SPO2_RDY{0x10};
+    static constexpr uint8_t INT_PWR_RDY{0x01};
+
+protected:
+    void write_register(const uint8_t reg, const uint8_t v)
+    {
+        switch (reg) {
+            case INT_STATUS:
+            case REVISION_ID:
+            case PART_ID:
+            case TEMP_INT:
+            case TEMP_FRAC:
+                break;  // Read only
+            case FIFO_WR_PTR:
+            case OVF_COUNTER:
+            case FIFO_RD_PTR:
+                _reg[reg] = v & 0x0F;
+                _full     = false;
+                _rbyte    = 0;
+                break;
+            case MODE_CONFIG:
+                if (v & 0x40) {
+                    powerOnReset();
+                    break;
+                }
+                if ((_reg[reg] ^ v) & 0x87) {
+                    _acc = 0;  // Conversion restarts
+                }
+                _reg[reg] = v & 0x8F;
+                if (v & 0x08) {
+                    // The conversion completes immediately in virtual time
+                    const float f   = std::floor(_temperature);
+                    _reg[TEMP_INT]  = static_cast<uint8_t>(static_cast<int8_t>(f));
+                    _reg[TEMP_FRAC] = static_cast<uint8_t>(std::lround((_temperature - f) / 0.0625f)) & 0x0F;
+                    _reg[MODE_CONFIG] &= ~0x08;
+                    _reg[INT_STATUS] |= INT_TEMP_RDY;
+                }
+                break;
+            case SPO2_CONFIG:
+                _reg[reg] = v & 0x5F;
+                _acc      = 0;
+                break;
+            default:
+                _reg[reg] = v;
+                break;
+        }
+    }
+
+    void generate(const uint32_t rate)
+    {
+        const bool spo2    = (_reg[MODE_CONFIG] & 0x07) == 0x03;
+        const uint32_t ir  = value(_generated, rate, 2) & 0xFFFF;
+        const uint32_t red = spo2 ? value(_generated, rate, 1) & 0xFFFF : 0;
+
+        uint8_t entry[SAMPLE_BYTES]{};
+        entry[0] = ir >> 8;
+        entry[1] = ir & 0xFF;
+        entry[2] = red >> 8;
+        entry[3] = red & 0xFF;
+        ++_generated;
+        _reg[INT_STATUS] |= INT_HR_RDY | (spo2 ? INT_SPO2_RDY : 0);
+
+        auto& wptr = _reg[FIFO_WR_PTR];
+        auto& ovf  = _reg[OVF_COUNTER];
+        if (_full) {
+            ++_lost;
+            ovf = (ovf < 0x0F) ? ovf + 1 : 0x0F;
+            return;
+        }
+        std::memcpy(_fifo[wptr], entry, sizeof(entry));
+        wptr  = (wptr + 1) & (FIFO_DEPTH - 1);
+        _full = (wptr == _reg[FIFO_RD_PTR]);
+
+        // One empty space left
+        if (unread() >= FIFO_DEPTH - 1) {
+            _reg[INT_STATUS] |= INT_A_FULL;
+        }
+    }
+
+    inline uint32_t value(const uint32_t index, const uint32_t rate, const uint8_t led)
+    {
+        if (_gen) {
+            return _gen(index, rate, led, _arg);
+        }
+        auto s = ppg_at(index, rate, _params);
+        return (led == 2) ? s.ir : (led == 1) ? s.red : 0;
+    }
+
+    uint8_t pop_byte()
+    {
+        auto& rptr      = _reg[FIFO_RD_PTR];
+        const uint8_t v = _fifo[rptr][_rbyte];
+        if (++_rbyte >= SAMPLE_BYTES) {
+            // A whole sample is popped
+            _rbyte            = 0;
+            rptr              = (rptr + 1) & (FIFO_DEPTH - 1);
+            _full             = false;
+            _reg[OVF_COUNTER] = 0;
+        }
+        return v;
+    }
+
+private:
+    uint8_t _reg[256]{};
+    uint8_t _fifo[FIFO_DEPTH][SAMPLE_BYTES]{};
+    uint8_t _ptr{}, _rbyte{};
+    bool _full{};
+
+    uint64_t _now{}, _acc{};
+    uint32_t _generated{}, _lost{};
+
+    Generator _gen{};
+    void* _arg{};
+    PPGParams _params{};
+    float _temperature{25.0f};
+};
+
+}  // namespace test
+}  // namespace heart
+}  // namespace m5
+#endif
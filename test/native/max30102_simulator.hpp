@@ -0,0 +1,359 @@
+/*
+ * SPDX-FileCopyrightText: 2026 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  Register-level MAX30102 model on the mock I2C bus
+  Samples are generated at the configured rate as the virtual time advances
+*/
+#ifndef M5_UNIT_HEART_TEST_NATIVE_MAX30102_SIMULATOR_HPP
+#define M5_UNIT_HEART_TEST_NATIVE_MAX30102_SIMULATOR_HPP
+
+#include "mock_i2c.hpp"
+#include "synthetic_ppg.hpp"
+#include <cmath>
+
+namespace m5 {
+namespace heart {
+namespace test {
+
+/*!
+  @class MAX30102Simulator
+  @brief MAX30102 registers, 32-deep FIFO, overflow counter, interrupt status and die temperature
+  @note Register auto-increment stops at FIFO_DATA, which pops the FIFO byte by byte
+  @note The read pointer advances even if the FIFO is empty, as the read pointer circling in reset_FIFO expects
+ */
+class MAX30102Simulator : public RegisterDevice {
+public:
+    static constexpr uint8_t FIFO_DEPTH{32};
+    static constexpr uint8_t MAX_SLOTS{4};
+
+    /*!
+      @brief Sample generator
+      @param index Sample index since the measurement started
+      @param rate Output rate of the FIFO (after averaging)
+      @param led LED (1:Red 2:IR)
+      @return 18 bits ADC value
+     */
+    using Generator = uint32_t (*)(const uint32_t index, const uint32_t rate, const uint8_t led, void* arg);
+
+    MAX30102Simulator()
+    {
+        powerOnReset();
+    }
+
+    //! @brief Power on reset
+    void powerOnReset()
+    {
+        std::memset(_reg, 0x00, sizeof(_reg));
+        _reg[PART_ID]     = 0x15;
+        _reg[REVISION_ID] = 0x03;
+        _reg[INT_STATUS_1] |= INT_PWR_RDY;
+        _ptr = _rbyte = 0;
+        _full         = false;
+        _acc          = 0;
+    }
+
+    ///@name Virtual time
+    ///@{
+    //! @brief Advance the virtual time and generate the samples in the meantime
+    void advance(const uint32_t us)
+    {
+        _now += us;
+        const uint32_t rate = samplingRate();
+        if (!rate) {
+            _acc = 0;
+            return;
+        }
+        // Exact in integers: a sample every 1e6 * avg / sps us
+        _acc += static_cast<uint64_t>(us) * sps();
+        const uint64_t period = 1000000ULL * average();
+        while (_acc >= period) {
+            _acc -= period;
+            generate(rate);
+        }
+    }
+    virtual uint64_t now() const override
+    {
+        return _now;
+    }
+    ///@}
+
+    //! @brief FIFO output rate (0 if not sampling)
+    inline uint32_t samplingRate() const
+    {
+        return channels() && !(_reg[MODE_CONFIG] & 0x80) ? sps() / average() : 0;
+    }
+    //! @brief Number of channels per FIFO sample
+    uint8_t channels() const
+    {
+        switch (_reg[MODE_CONFIG] & 0x07) {
+            case 0x02:
+                return 1;
+            case 0x03:
+                return 2;
+            case 0x07: {
+                uint8_t n{};
+                while (n < MAX_SLOTS && slot(n)) {
+                    ++n;
+                }
+                return n;
+            }
+            default:
+                return 0;
+        }
+    }
+    //! @brief Number of unread samples
+    inline uint8_t unread() const
+    {
+        return _full ? FIFO_DEPTH : static_cast<uint8_t>((_reg[FIFO_WR_PTR] - _reg[FIFO_RD_PTR]) & (FIFO_DEPTH - 1));
+    }
+    //! @brief Number of samples generated
+    inline uint32_t generated() const
+    {
+        return _generated;
+    }
+    //! @brief Number of samples lost by overflow in total (the register saturates, this does not)
+    inline uint32_t lost() const
+    {
+        return _lost;
+    }
+    //! @brief INT pin (active low) is asserted?
+    inline bool interrupt() const
+    {
+        return (_reg[INT_STATUS_1] & _reg[INT_ENABLE_1]) || (_reg[INT_STATUS_2] & _reg[INT_ENABLE_2]);
+    }
+    //! @brief Register value without side effects
+    inline uint8_t peek(const uint8_t reg) const
+    {
+        return _reg[reg];
+    }
+
+    //! @brief Replace the generator (nullptr:synthetic PPG)
+    inline void setGenerator(Generator gen, void* arg = nullptr)
+    {
+        _gen = gen;
+        _arg = arg;
+    }
+    inline void setPPGParams(const PPGParams& p)
+    {
+        _params = p;
+    }
+    //! @brief Die temperature (Celsius)
+    inline void setTemperature(const float c)
+    {
+        _temperature = c;
+    }
+
+    virtual bool write(const uint8_t* data, const size_t len) override
+    {
+        if (!len) {
+            return true;
+        }
+        _ptr = data[0];
+        for (size_t i = 1; i < len; ++i) {
+            write_register(_ptr, data[i]);
+            if (_ptr != FIFO_DATA) {
+                ++_ptr;
+            }
+        }
+        return true;
+    }
+
+    virtual bool read(uint8_t* buf, const size_t len) override
+    {
+        for (size_t i = 0; i < len; ++i) {
+            if (_ptr == FIFO_DATA) {
+                buf[i] = pop_byte();
+                continue;
+            }
+            buf[i] = _reg[_ptr];
+            if (_ptr == INT_STATUS_1 || _ptr == INT_STATUS_2) {
+                _reg[_ptr] = 0;  // Cleared by reading
+            }
+            ++_ptr;
+        }
+        return true;
+    }
+
+    // Registers
+    static constexpr uint8_t INT_STATUS_1{0x00};
+    static constexpr uint8_t INT_STATUS_2{0x01};
+    static constexpr uint8_t INT_ENABLE_1{0x02};
+    static constexpr uint8_t INT_ENABLE_2{0x03};
+    static constexpr uint8_t FIFO_WR_PTR{0x04};
+    static constexpr uint8_t OVF_COUNTER{0x05};
+    static constexpr uint8_t FIFO_RD_PTR{0x06};
+    static constexpr uint8_t FIFO_DATA{0x07};
+    static constexpr uint8_t FIFO_CONFIG{0x08};
+    static constexpr uint8_t MODE_CONFIG{0x09};
+    static constexpr uint8_t SPO2_CONFIG{0x0A};
+    static constexpr uint8_t LED1_PA{0x0C};
+    static constexpr uint8_t LED2_PA{0x0D};
+    static constexpr uint8_t MULTI_LED_12{0x11};
+    static constexpr uint8_t MULTI_LED_34{0x12};
+    static constexpr uint8_t TEMP_INT{0x1F};
+    static constexpr uint8_t TEMP_FRAC{0x20};
+    static constexpr uint8_t TEMP_CONFIG{0x21};
+    static constexpr uint8_t REVISION_ID{0xFE};
+    static constexpr uint8_t PART_ID{0xFF};
+    // Interrupt bits
+    static constexpr uint8_t INT_A_FULL{0x80};
+    static constexpr uint8_t INT_PPG_RDY{0x40};
+    static constexpr uint8_t INT_PWR_RDY{0x01};
+    static constexpr uint8_t INT_DIE_TEMP_RDY{0x02};
+
+protected:
+    inline uint32_t sps() const
+    {
+        constexpr uint32_t table[] = {50, 100, 200, 400, 800, 1000, 1600, 3200};
+        return table[(_reg[SPO2_CONFIG] >> 2) & 0x07];
+    }
+    inline uint32_t average() const
+    {
+        constexpr uint32_t table[] = {1, 2, 4, 8, 16, 32, 32, 32};
+        return table[(_reg[FIFO_CONFIG] >> 5) & 0x07];
+    }
+    // LED of the slot (0:None 1:Red 2:IR)
+    inline uint8_t slot(const uint8_t idx) const
+    {
+        return (_reg[MULTI_LED_12 + (idx >> 1)] >> ((idx & 1) ? 4 : 0)) & 0x07;
+    }
+
+    void write_register(const uint8_t reg, const uint8_t v)
+    {
+        switch (reg) {
+            case INT_STATUS_1:
+            case INT_STATUS_2:
+            case REVISION_ID:
+            case PART_ID:
+            case TEMP_INT:
+            case TEMP_FRAC:
+                break;  // Read only
+            case FIFO_WR_PTR:
+            case OVF_COUNTER:
+            case FIFO_RD_PTR:
+                _reg[reg] = v & 0x1F;
+                _full     = false;
+                _rbyte    = 0;
+                break;
+            case MODE_CONFIG:
+                if (v & 0x40) {
+                    powerOnReset();
+                    break;
+                }
+                _reg[reg] = v & 0x87;
+                _acc      = 0;  // Conversion restarts
+                break;
+            case SPO2_CONFIG:
+                _reg[reg] = v & 0x7F;
+                _acc      = 0;
+                break;
+            case FIFO_CONFIG:
+                _reg[reg] = v;
+                _acc      = 0;
+                break;
+            case MULTI_LED_12:
+            case MULTI_LED_34:
+                _reg[reg] = v & 0x77;
+                break;
+            case TEMP_CONFIG:
+                if (v & 0x01) {
+                    // The conversion completes immediately in virtual time
+                    const float f   = std::floor(_temperature);
+                    _reg[TEMP_INT]  = static_cast<uint8_t>(static_cast<int8_t>(f));
+                    _reg[TEMP_FRAC] = static_cast<uint8_t>(std::lround((_temperature - f) / 0.0625f)) & 0x0F;
+                    _reg[INT_STATUS_2] |= INT_DIE_TEMP_RDY;
+                }
+                break;
+            default:
+                _reg[reg] = v;
+                break;
+        }
+    }
+
+    void generate(const uint32_t rate)
+    {
+        uint8_t entry[MAX_SLOTS * 3]{};
+        const uint8_t ch = channels();
+        for (uint8_t i = 0; i < ch; ++i) {
+            // HR:Red SpO2:Red,IR MultiLED:as the slots
+            const uint8_t led = ((_reg[MODE_CONFIG] & 0x07) == 0x07) ? slot(i) : (i + 1);
+            const uint32_t v  = value(_generated, rate, led) & 0x3FFFF;
+            entry[i * 3 + 0]  = (v >> 16) & 0xFF;
+            entry[i * 3 + 1]  = (v >> 8) & 0xFF;
+            entry[i * 3 + 2]  = v & 0xFF;
+        }
+        ++_generated;
+        _reg[INT_STATUS_1] |= INT_PPG_RDY;
+
+        auto& wptr = _reg[FIFO_WR_PTR];
+        auto& rptr = _reg[FIFO_RD_PTR];
+        auto& ovf  = _reg[OVF_COUNTER];
+        if (_full) {
+            ++_lost;
+            ovf = (ovf < 0x1F) ? ovf + 1 : 0x1F;
+            if (!(_reg[FIFO_CONFIG] & 0x10)) {
+                return;  // Not updated until the data is read or the pointers are changed
+            }
+            // Roll over: the oldest is overwritten
+            rptr   = (rptr + 1) & (FIFO_DEPTH - 1);
+            _rbyte = 0;
+        }
+        std::memcpy(_fifo[wptr], entry, sizeof(entry));
+        wptr  = (wptr + 1) & (FIFO_DEPTH - 1);
+        _full = (wptr == rptr);
+
+        const uint8_t threshold = FIFO_DEPTH - (_reg[FIFO_CONFIG] & 0x0F);
+        if (unread() >= threshold) {
+            _reg[INT_STATUS_1] |= INT_A_FULL;
+        }
+    }
+
+    inline uint32_t value(const uint32_t index, const uint32_t rate, const uint8_t led)
+    {
+        if (_gen) {
+            return _gen(index, rate, led, _arg);
+        }
+        auto s = ppg_at(index, rate, _params);
+        return (led == 2) ? s.ir : (led == 1) ? s.red : 0;
+    }
+
+    uint8_t pop_byte()
+    {
+        const uint8_t bytes = channels() * 3;
+        if (!bytes) {
+            return 0;
+        }
+        auto& rptr      = _reg[FIFO_RD_PTR];
+        const uint8_t v = _fifo[rptr][_rbyte];
+        if (++_rbyte >= bytes) {
+            // A whole sample is popped
+            _rbyte            = 0;
+            rptr              = (rptr + 1) & (FIFO_DEPTH - 1);
+            _full             = false;
+            _reg[OVF_COUNTER] = 0;
+        }
+        return v;
+    }
+
+private:
+    uint8_t _reg[256]{};
+    uint8_t _fifo[FIFO_DEPTH][MAX_SLOTS * 3]{};
+    uint8_t _ptr{}, _rbyte{};
+    bool _full{};
+
+    uint64_t _now{}, _acc{};
+    uint32_t _generated{}, _lost{};
+
+    Generator _gen{};
+    void* _arg{};
+    PPGParams _params{};
+    float _temperature{25.0f};
+};
+
+}  // namespace test
+}  // namespace heart
+}  // namespace m5
+#endif
@@ -0,0 +1,253 @@
+/*
+ * SPDX-FileCopyrightText: 2026 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  Mock I2C bus for native tests
+  The unit talks to a register-level device model through an adapter instead of the real bus
+*/
+#ifndef M5_UNIT_HEART_TEST_NATIVE_MOCK_I2C_HPP
+#define M5_UNIT_HEART_TEST_NATIVE_MOCK_I2C_HPP
+
+#include <M5UnitComponent.hpp>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+
+namespace m5 {
+namespace heart {
+namespace test {
+
+/*!
+  @struct I2CStatistics
+  @brief Traffic on the mock bus
+ */
+struct I2CStatistics {
+    uint32_t transactions{};     // Number of START (or repeated START) conditions
+    uint32_t repeated_starts{};  // Writes without STOP (the next transaction starts with the repeated START)
+    uint32_t reads{}, writes{};
+    uint64_t read_bytes{}, write_bytes{};  // Payload only
+    //! @brief Bytes on the wire including the address byte of each transaction
+    inline uint64_t wire_bytes() const
+    {
+        return read_bytes + write_bytes + transactions;
+    }
+    inline void clear()
+    {
+        *this = I2CStatistics{};
+    }
+};
+
+/*!
+  @class RegisterDevice
+  @brief Device model on the mock bus
+ */
+class RegisterDevice {
+public:
+    virtual ~RegisterDevice() = default;
+
+    //! @brief Master writes (the first byte is the register address)
+    virtual bool write(const uint8_t* data, const size_t len) = 0;
+    //! @brief Master reads from the current register address
+    virtual bool read(uint8_t* buf, const size_t len) = 0;
+    //! @brief Virtual time (us)
+    virtual uint64_t now() const = 0;
+
+    inline const I2CStatistics& statistics() const
+    {
+        return _stats;
+    }
+    inline void clearStatistics()
+    {
+        _stats.clear();
+    }
+    //! @brief Make the following transactions fail (bus error)
+    inline void setFailure(const bool fail)
+    {
+        _fail = fail;
+    }
+
+protected:
+    friend class MockI2CImpl;
+    friend class MockAsyncI2C;
+    I2CStatistics _stats{};
+    bool _fail{};
+};
+
+/*!
+  @class MockI2CImpl
+  @brief Adapter implementation forwarding transactions to the device model
+ */
+class MockI2CImpl : public m5::unit::Adapter::Impl {
+public:
+    explicit MockI2CImpl(RegisterDevice& dev) : _dev{dev}
+    {
+    }
+
+    virtual m5::hal::error::error_t readWithTransaction(uint8_t* data, const size_t len) override
+    {
+        auto& st = _dev._stats;
+        ++st.transactions;
+        ++st.reads;
+        st.read_bytes += len;
+        return (!_dev._fail && _dev.read(data, len)) ? m5::hal::error::error_t::OK
+                                                     : m5::hal::error::error_t::I2C_BUS_ERROR;
+    }
+
+    virtual m5::hal::error::error_t writeWithTransaction(const uint8_t* data, const size_t len,
+                                                         const uint32_t stop) override
+    {
+        auto& st = _dev._stats;
+        ++st.transactions;
+        ++st.writes;
+        st.repeated_starts += !stop;
+        st.write_bytes += len;
+        return (!_dev._fail && _dev.write(data, len)) ? m5::hal::error::error_t::OK
+                                                      : m5::hal::error::error_t::I2C_BUS_ERROR;
+    }
+
+    virtual m5::hal::error::error_t writeWithTransaction(const uint8_t reg, const uint8_t* data, const size_t len,
+                                                         const uint32_t stop) override
+    {
+        uint8_t buf[1 + 32]{reg};
+        if (len > sizeof(buf) - 1) {
+            return m5::hal::error::error_t::UNKNOWN_ERROR;
+        }
+        if (data && len) {
+            std::memcpy(buf + 1, data, len);
+        }
+        return writeWithTransaction(buf, len + 1, stop);
+    }
+
+private:
+    RegisterDevice& _dev;
+};
+
+/*!
+  @class MockAdapter
+  @brief I2C adapter connected to the device model
+ */
+class MockAdapter : public m5::unit::Adapter {
+public:
+    explicit MockAdapter(RegisterDevice& dev) : m5::unit::Adapter(Type::I2C, new MockI2CImpl(dev))
+    {
+    }
+};
+
+/*!
+  @class MockAsyncI2C
+  @brief Asynchronous read on the mock bus with the completion latency
+  @details start() (async_read_function_t of the units) only takes the request, and advance() completes it when the
+  time on the wire (9 clocks per byte) and the setup latency have passed, then calls the completion callback.
+  The data is read from the device on the completion, as the DMA of the real bus
+ */
+class MockAsyncI2C {
+public:
+    using complete_function_t = void (*)(const bool ok, void* arg);
+
+    explicit MockAsyncI2C(RegisterDevice& dev, const uint32_t clock = 400 * 1000U, const uint32_t latency_us = 50)
+        : _dev{dev}, _clock{clock}, _latency{latency_us}
+    {
+    }
+
+    //! @brief Set the completion callback
+    inline void setCallback(complete_function_t func, void* arg)
+    {
+        _complete     = func;
+        _complete_arg = arg;
+    }
+
+    //! @brief async_read_function_t (arg is this)
+    static bool start(const uint8_t reg, uint8_t* dst, const uint32_t len, void* arg)
+    {
+        auto self = static_cast<MockAsyncI2C*>(arg);
+        if (self->_busy) {
+            return false;
+        }
+        self->_busy = true;
+        self->_reg  = reg;
+        self->_dst  = dst;
+        self->_len  = len;
+        // Address, register and address, data
+        self->_left = self->_latency + static_cast<uint32_t>(9ULL * 1000000 * (3 + len) / self->_clock);
+        ++self->_started;
+        return true;
+    }
+
+    //! @brief Advance the time of the transfer, and complete it if the time is up
+    void advance(const uint32_t us)
+    {
+        if (!_busy) {
+            return;
+        }
+        if (us < _left) {
+            _left -= us;
+            return;
+        }
+        _busy    = false;
+        auto& st = _dev._stats;
+        st.transactions += 2;
+        ++st.writes;
+        ++st.reads;
+        ++st.repeated_starts;
+        st.write_bytes += 1;
+        st.read_bytes += _len;
+        const bool ok = !_dev._fail && _dev.write(&_reg, 1) && _dev.read(_dst, _len);
+        if (_complete) {
+            _complete(ok, _complete_arg);
+        }
+    }
+
+    //! @brief Abort the transfer without the completion (as the driver timed out)
+    inline void cancel()
+    {
+        _busy = false;
+    }
+
+    //! @brief Is the transfer in progress?
+    inline bool busy() const
+    {
+        return _busy;
+    }
+    //! @brief Number of the transfers started
+    inline uint32_t started() const
+    {
+        return _started;
+    }
+
+private:
+    RegisterDevice& _dev;
+    uint32_t _clock{}, _latency{};
+    complete_function_t _complete{};
+    void* _complete_arg{};
+    bool _busy{};
+    uint8_t _reg{};
+    uint8_t* _dst{};
+    uint32_t _len{}, _left{}, _started{};
+};
+
+/*!
+  @class MockedUnit
+  @brief Unit connected to the mock bus
+  @tparam U Unit class
+ */
+template <class U>
+class MockedUnit : public U {
+public:
+    explicit MockedUnit(RegisterDevice& dev) : U()
+    {
+        this->_adapter = std::make_shared<MockAdapter>(dev);
+        // The unit sees the virtual time of the device
+        this->_timeline.micros = [](void* arg) {
+            return static_cast<uint32_t>(static_cast<RegisterDevice*>(arg)->now());
+        };
+        this->_timeline.micros_arg = &dev;
+    }
+};
+
+}  // namespace test
+}  // namespace heart
+}  // namespace m5
+#endif
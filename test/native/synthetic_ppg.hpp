@@ -0,0 +1,110 @@
+/*
+ * SPDX-FileCopyrightText: 2026 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  Synthetic PPG traces for native tests and benchmarks
+*/
+#ifndef M5_UNIT_HEART_TEST_NATIVE_SYNTHETIC_PPG_HPP
+#define M5_UNIT_HEART_TEST_NATIVE_SYNTHETIC_PPG_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace m5 {
+namespace heart {
+namespace test {
+
+struct PPGSample {
+    uint32_t ir{}, red{};
+};
+
+/*!
+  @struct PPGParams
+  @brief Parameters of the synthetic trace
+  @note Raw IR/Red decrease as the blood volume increases, as the sensor outputs do
+ */
+struct PPGParams {
+    float bpm{72.f};            // Mean heart rate
+    float variability{0.03f};   // RR jitter ratio
+    float ir_dc{50000.f};       // IR DC level
+    float ir_ac{1500.f};        // IR pulse amplitude
+    float red_dc{40000.f};      // Red DC level
+    float red_ac{600.f};        // Red pulse amplitude
+    float wander{300.f};        // Baseline wander amplitude (0.2 Hz)
+    float noise{8.f};           // Gaussian noise sigma
+    uint32_t max_value{0x3FFFF};  // ADC full scale
+    uint32_t seed{1};
+};
+
+// Fast systolic upstroke and exponential diastolic decay, phase 0.0 - 1.0
+inline float pulse_shape(const float phase)
+{
+    return (phase < 0.12f) ? phase / 0.12f : std::exp(-(phase - 0.12f) / 0.25f);
+}
+
+inline std::vector<PPGSample> make_ppg(const uint32_t sampling_rate, const float seconds, const PPGParams& p = {})
+{
+    constexpr float pi{3.14159265358979323846f};
+    std::mt19937 rng(p.seed);
+    std::normal_distribution<float> noise(0.0f, p.noise);
+    std::uniform_real_distribution<float> jitter(-p.variability, p.variability);
+
+    const size_t num = static_cast<size_t>(sampling_rate * seconds);
+    std::vector<PPGSample> v(num);
+
+    float phase{}, rr = 60.f / p.bpm;
+    for (size_t i = 0; i < num; ++i) {
+        const float t      = static_cast<float>(i) / sampling_rate;
+        const float shape  = pulse_shape(phase);
+        const float wander = p.wander * std::sin(2.0f * pi * 0.2f * t);
+        auto clamp         = [&p](const float x) {
+            return static_cast<uint32_t>(std::fmin(std::fmax(x, 0.0f), static_cast<float>(p.max_value)));
+        };
+        v[i].ir  = clamp(p.ir_dc + wander - p.ir_ac * shape + noise(rng));
+        v[i].red = clamp(p.red_dc + wander * 0.8f - p.red_ac * shape + noise(rng));
+
+        phase += 1.0f / (rr * sampling_rate);
+        if (phase >= 1.0f) {
+            phase -= 1.0f;
+            rr = (60.f / p.bpm) * (1.0f + jitter(rng));
+        }
+    }
+    return v;
+}
+
+/*!
+  @brief Sample of the synthetic trace at the index, without any state or allocation
+  @details Fixed RR and hash based uniform noise, so that register simulators can generate samples on demand
+ */
+inline PPGSample ppg_at(const uint32_t index, const uint32_t sampling_rate, const PPGParams& p = {})
+{
+    constexpr double pi{3.14159265358979323846};
+    const double t      = static_cast<double>(index) / sampling_rate;
+    const double cycles = t * p.bpm / 60.0;
+    const float shape   = pulse_shape(static_cast<float>(cycles - std::floor(cycles)));
+    const float wander  = p.wander * static_cast<float>(std::sin(2.0 * pi * 0.2 * t));
+
+    auto noise = [&p, index](const uint32_t salt) {
+        uint32_t h = (index ^ p.seed ^ salt) * 0x9E3779B1U;
+        h ^= h >> 15;
+        h *= 0x85EBCA77U;
+        h ^= h >> 13;
+        return p.noise * (static_cast<float>(h & 0xFFFF) / 32767.5f - 1.0f);
+    };
+    auto clamp = [&p](const float x) {
+        return static_cast<uint32_t>(std::fmin(std::fmax(x, 0.0f), static_cast<float>(p.max_value)));
+    };
+    PPGSample s{};
+    s.ir  = clamp(p.ir_dc + wander - p.ir_ac * shape + noise(0x1234U));
+    s.red = clamp(p.red_dc + wander * 0.8f - p.red_ac * shape + noise(0xABCDU));
+    return s;
+}
+
+}  // namespace test
+}  // namespace heart
+}  // namespace m5
+#endif
@@ -0,0 +1,233 @@
+/*
+ * SPDX-FileCopyrightText: 2026 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for SPSCRing and AcquisitionRunner (std::thread in place of the FreeRTOS task)
+*/
+#include <gtest/gtest.h>
+#include <unit/unit_MAX30102.hpp>
+#include <unit/unit_MAX30100.hpp>
+#include <utility/acquisition_runner.hpp>
+#include "../mock_i2c.hpp"
+#include "../max30102_simulator.hpp"
+#include "../max30100_simulator.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace m5::unit;
+using namespace m5::heart;
+using namespace m5::heart::test;
+
+namespace {
+
+// The value tells the sample index and the LED
+uint32_t index_generator(const uint32_t index, const uint32_t, const uint8_t led, void*)
+{
+    return ((index << 2) | led) & 0xFFFF;
+}
+
+/*
+  The simulator advances by the real time in update(), so that only the task touches the simulator while running
+ */
+template <class U, class S>
+class TimedUnit : public MockedUnit<U> {
+public:
+    explicit TimedUnit(S& sim) : MockedUnit<U>(sim), _sim(sim)
+    {
+    }
+    virtual void update(const bool force = false) override
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (_started) {
+            _sim.advance(std::chrono::duration_cast<std::chrono::microseconds>(now - _prev).count());
+        }
+        _started = true;
+        _prev    = now;
+        MockedUnit<U>::update(force);
+    }
+
+private:
+    S& _sim;
+    bool _started{};
+    std::chrono::steady_clock::time_point _prev{};
+};
+
+void sleep_ms(const uint32_t ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+}  // namespace
+
+TEST(SPSCRing, Basic)
+{
+    SPSCRing<uint32_t, 8> ring;
+    EXPECT_EQ(ring.capacity(), 8U);
+    EXPECT_TRUE(ring.empty());
+
+    uint32_t v{};
+    EXPECT_FALSE(ring.pop(v));
+
+    for (uint32_t i = 0; i < 8; ++i) {
+        EXPECT_TRUE(ring.push(i));
+    }
+    EXPECT_TRUE(ring.full());
+    EXPECT_FALSE(ring.push(8));
+    EXPECT_EQ(ring.dropped(), 1U);
+
+    // Wrap around
+    for (uint32_t i = 0; i < 100; ++i) {
+        ASSERT_TRUE(ring.pop(v));
+        EXPECT_EQ(v, i);
+        EXPECT_TRUE(ring.push(i + 8));
+    }
+    uint32_t buf[16]{};
+    EXPECT_EQ(ring.pop(buf, 3), 3U);
+    EXPECT_EQ(buf[0], 100U);
+    EXPECT_EQ(buf[2], 102U);
+    EXPECT_EQ(ring.pop(buf, 16), 5U);
+    EXPECT_EQ(buf[4], 107U);
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(SPSCRing, Threads)
+{
+    constexpr uint32_t count{1000000};
+    SPSCRing<uint32_t, 64> ring;
+
+    std::thread producer([&ring]() {
+        for (uint32_t i = 0; i < count; ++i) {
+            while (!ring.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    // size() of the other thread never wraps while both sides are running
+    std::atomic<bool> done{false};
+    uint32_t wrapped{};
+    std::thread observer([&ring, &done, &wrapped]() {
+        while (!done.load()) {
+            wrapped += (ring.size() > ring.capacity());
+        }
+    });
+
+    uint32_t expected{}, mismatch{};
+    uint32_t buf[16]{};
+    while (expected < count) {
+        const size_t n = ring.pop(buf, 16);
+        for (size_t i = 0; i < n; ++i) {
+            mismatch += (buf[i] != expected++);
+        }
+        if (!n) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    done = true;
+    observer.join();
+    EXPECT_EQ(mismatch, 0U);
+    EXPECT_EQ(wrapped, 0U);
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(AcquisitionRunner, MAX30102)
+{
+    MAX30102Simulator sim{};
+    sim.setGenerator(index_generator);
+    TimedUnit<UnitMAX30102, MAX30102Simulator> unit(sim);
+    ASSERT_TRUE(unit.begin());
+    ASSERT_EQ(sim.samplingRate(), 100U);
+
+    AcquisitionRunner<TimedUnit<UnitMAX30102, MAX30102Simulator>> runner(unit);
+    ASSERT_TRUE(runner.start());
+    EXPECT_TRUE(runner.running());
+    EXPECT_FALSE(runner.start());        // Already running
+    EXPECT_EQ(runner.interval(), 160U);  // Half of the FIFO at 100 sps
+
+    // Slow frames of the consumer, longer than the FIFO (320 ms)
+    std::vector<Sample> samples{};
+    for (uint32_t frame = 0; frame < 3; ++frame) {
+        sleep_ms(500);
+        Sample s{};
+        while (runner.pop(s)) {
+            samples.push_back(s);
+        }
+    }
+    runner.stop();
+    EXPECT_FALSE(runner.running());
+
+    EXPECT_GE(samples.size(), 100U);
+    EXPECT_EQ(runner.dropped(), 0U);
+    EXPECT_EQ(runner.lost(), 0U);
+    EXPECT_EQ(sim.lost(), 0U);
+    uint32_t mismatch{};
+    for (size_t i = 0; i < samples.size(); ++i) {
+        mismatch += (samples[i].ir != index_generator(i, 0, 2, nullptr)) +
+                    (samples[i].red != index_generator(i, 0, 1, nullptr)) + (samples[i].gap != 0);
+    }
+    EXPECT_EQ(mismatch, 0U);
+}
+
+TEST(AcquisitionRunner, Dropped)
+{
+    MAX30102Simulator sim{};
+    sim.setGenerator(index_generator);
+    TimedUnit<UnitMAX30102, MAX30102Simulator> unit(sim);
+    ASSERT_TRUE(unit.begin());
+
+    AcquisitionRunner<TimedUnit<UnitMAX30102, MAX30102Simulator>, 16> runner(unit);
+    AcquisitionRunner<TimedUnit<UnitMAX30102, MAX30102Simulator>, 16>::config_t cfg{};
+    cfg.interval = 50;
+    ASSERT_TRUE(runner.start(cfg));
+    EXPECT_EQ(runner.interval(), 50U);
+    sleep_ms(500);
+    runner.stop();
+
+    // The ring keeps the oldest, and the rest are dropped (the sensor does not overflow)
+    EXPECT_EQ(runner.available(), 16U);
+    EXPECT_GT(runner.dropped(), 0U);
+    EXPECT_EQ(runner.lost(), 0U);
+    Sample s{};
+    for (uint32_t i = 0; i < 16; ++i) {
+        ASSERT_TRUE(runner.pop(s));
+        EXPECT_EQ(s.ir, index_generator(i, 0, 2, nullptr));
+    }
+
+    // The gap of the dropped samples does not carry over to the next run
+    const uint32_t dropped = runner.dropped();
+    ASSERT_TRUE(runner.start(cfg));
+    sleep_ms(100);
+    runner.stop();
+    ASSERT_TRUE(runner.pop(s));
+    EXPECT_EQ(s.gap, 0U);
+    EXPECT_EQ(s.ir, index_generator(16 + dropped, 0, 2, nullptr));
+}
+
+TEST(AcquisitionRunner, MAX30100)
+{
+    MAX30100Simulator sim{};
+    sim.setGenerator(index_generator);
+    TimedUnit<UnitMAX30100, MAX30100Simulator> unit(sim);
+    ASSERT_TRUE(unit.begin());
+
+    AcquisitionRunner<TimedUnit<UnitMAX30100, MAX30100Simulator>> runner(unit);
+    ASSERT_TRUE(unit.stopPeriodicMeasurement());
+    EXPECT_FALSE(runner.start());  // Not in periodic
+    ASSERT_TRUE(unit.startPeriodicMeasurement());
+    const uint32_t base = sim.generated();
+    ASSERT_TRUE(runner.start());
+    sleep_ms(500);
+    runner.stop();
+
+    std::vector<Sample> samples(runner.available());
+    EXPECT_EQ(runner.pop(samples.data(), samples.size()), samples.size());
+    EXPECT_GE(samples.size(), 10U);
+    EXPECT_EQ(runner.lost(), 0U);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        EXPECT_EQ(samples[i].ir, index_generator(base + i, 0, 2, nullptr));
+    }
+}
@@ -0,0 +1,287 @@
+/*
+ * SPDX-FileCopyrightText: 2026 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  Benchmark for the DSP cost of EMA, Filter, BiquadFilter and PulseMonitor,
+  and the fixed-point and multi-channel versions
+  At each sampling rate supported by MAX30102/MAX30100, with 1 - 10 sec windows
+  @note The host has FPU, so the speedup of the fixed-point versions is larger on the targets without FPU
+*/
+#include <gtest/gtest.h>
+#include <unit/unit_MAX30102.hpp>
+#include <unit/unit_MAX30100.hpp>
+#include <utility/pulse_monitor.hpp>
+#include <utility/fixed_pulse_monitor.hpp>
+#include <utility/pulse_monitor_bank.hpp>
+#include "../synthetic_ppg.hpp"
+#include "../bench_helper.hpp"
+#include <string>
+#include <vector>
+#include <memory>
+
+using namespace m5::heart;
+using namespace m5::heart::test;
+
+namespace {
+
+template <typename E>
+struct RateEntry {
+    E sampling;
+    uint32_t rate;
+};
+
+constexpr RateEntry<m5::unit::max30102::Sampling> max30102_rate_table[] = {
+    {m5::unit::max30102::Sampling::Rate50, 50},     {m5::unit::max30102::Sampling::Rate100, 100},
+    {m5::unit::max30102::Sampling::Rate200, 200},   {m5::unit::max30102::Sampling::Rate400, 400},
+    {m5::unit::max30102::Sampling::Rate800, 800},   {m5::unit::max30102::Sampling::Rate1000, 1000},
+    {m5::unit::max30102::Sampling::Rate1600, 1600}, {m5::unit::max30102::Sampling::Rate3200, 3200},
+};
+constexpr RateEntry<m5::unit::max30100::Sampling> max30100_rate_table[] = {
+    {m5::unit::max30100::Sampling::Rate50, 50},   {m5::unit::max30100::Sampling::Rate100, 100},
+    {m5::unit::max30100::Sampling::Rate167, 167}, {m5::unit::max30100::Sampling::Rate200, 200},
+    {m5::unit::max30100::Sampling::Rate400, 400}, {m5::unit::max30100::Sampling::Rate600, 600},
+    {m5::unit::max30100::Sampling::Rate800, 800}, {m5::unit::max30100::Sampling::Rate1000, 1000},
+};
+static_assert(sizeof(max30102_rate_table) / sizeof(max30102_rate_table[0]) ==
+                  m5::stl::to_underlying(m5::unit::max30102::Sampling::Rate3200) + 1U,
+              "All the MAX30102 sampling rates must be covered");
+static_assert(sizeof(max30100_rate_table) / sizeof(max30100_rate_table[0]) ==
+                  m5::stl::to_underlying(m5::unit::max30100::Sampling::Rate1000) + 1U,
+              "All the MAX30100 sampling rates must be covered");
+
+constexpr uint32_t sec_min{1};
+constexpr uint32_t sec_max{10};
+constexpr float trace_seconds{30.f};
+
+struct Trace {
+    std::vector<float> ir, red;
+    std::vector<uint32_t> raw_ir, raw_red;
+};
+
+Trace make_trace(const uint32_t rate)
+{
+    auto ppg = make_ppg(rate, trace_seconds);
+    Trace t{};
+    t.ir.reserve(ppg.size());
+    t.red.reserve(ppg.size());
+    for (auto&& s : ppg) {
+        t.ir.push_back(static_cast<float>(s.ir));
+        t.red.push_back(static_cast<float>(s.red));
+        t.raw_ir.push_back(s.ir);
+        t.raw_red.push_back(s.red);
+    }
+    return t;
+}
+
+void bench_rate(const char* chip, const uint32_t rate)
+{
+    const auto trace = make_trace(rate);
+    const size_t num = trace.ir.size();
+    const std::string prefix{std::string(chip) + " " + std::to_string(rate) + "sps "};
+
+    auto r = bench(num, [&]() {
+        EMA ema(0.95f);
+        float v{};
+        for (auto&& s : trace.ir) {
+            v = ema.update(s);
+        }
+        do_not_optimize(v);
+    });
+    print_result((prefix + "EMA::update").c_str(), r);
+    EXPECT_GT(r.samples_per_sec, rate);
+
+    r = bench(num, [&]() {
+        Filter filter(5.0f, rate);
+        float v{};
+        for (auto&& s : trace.ir) {
+            v = filter.process(s);
+        }
+        do_not_optimize(v);
+    });
+    print_result((prefix + "Filter::process").c_str(), r);
+    EXPECT_GT(r.samples_per_sec, rate);
+
+    r = bench(num, [&]() {
+        BiquadFilter filter{};
+        filter.setSamplingRate(rate);
+        float v{};
+        for (auto&& s : trace.ir) {
+            v = filter.process(s);
+        }
+        do_not_optimize(v);
+    });
+    print_result((prefix + "BiquadFilter::process").c_str(), r);
+    EXPECT_GT(r.samples_per_sec, rate);
+
+    r = bench(num, [&]() {
+        FixedFilter filter(5.0f, rate);
+        int32_t v{};
+        for (auto&& s : trace.raw_ir) {
+            v = filter.process(s);
+        }
+        do_not_optimize(v);
+    });
+    print_result((prefix + "FixedFilter::process").c_str(), r);
+    EXPECT_GT(r.samples_per_sec, rate);
+
+    for (uint32_t sec = sec_min; sec <= sec_max; ++sec) {
+        // push_back(ir, red) and update() per sample, as the examples do
+        r = bench(num, [&]() {
+            PulseMonitor monitor(rate, sec);
+            for (size_t i = 0; i < num; ++i) {
+                monitor.push_back(trace.ir[i], trace.red[i]);
+                monitor.update();
+            }
+            do_not_optimize(monitor.bpm());
+        });
+        print_result((prefix + std::to_string(sec) + "s PulseMonitor::update").c_str(), r);
+        EXPECT_GT(r.samples_per_sec, rate);
+
+        // update() per sample, but bpm() is read once per second
+        r = bench(num, [&]() {
+            PulseMonitor monitor(rate, sec);
+            float bpm{};
+            for (size_t i = 0; i < num; ++i) {
+                monitor.push_back(trace.ir[i], trace.red[i]);
+                monitor.update();
+                if (i % rate == 0) {
+                    bpm = monitor.bpm();
+                }
+            }
+            do_not_optimize(bpm);
+        });
+        print_result((prefix + std::to_string(sec) + "s PulseMonitor::update (bpm 1Hz)").c_str(), r);
+        EXPECT_GT(r.samples_per_sec, rate);
+
+        // process() per FIFO batch (32 samples)
+        r = bench(num, [&]() {
+            PulseMonitor monitor(rate, sec);
+            bool beats[32]{};
+            for (size_t i = 0; i < num; i += 32) {
+                monitor.process(trace.ir.data() + i, trace.red.data() + i, std::min<size_t>(32, num - i), beats);
+            }
+            do_not_optimize(monitor.bpm());
+        });
+        print_result((prefix + std::to_string(sec) + "s PulseMonitor::process").c_str(), r);
+        EXPECT_GT(r.samples_per_sec, rate);
+
+        // BPM by the Goertzel bank at 4 Hz
+        r = bench(num, [&]() {
+            PulseMonitor monitor(rate, sec);
+            monitor.enableGoertzelBPM(4.0f);
+            for (size_t i = 0; i < num; ++i) {
+                monitor.push_back(trace.ir[i], trace.red[i]);
+                monitor.update();
+            }
+            do_not_optimize(monitor.bpm());
+        });
+        print_result((prefix + std::to_string(sec) + "s PulseMonitor::update (Goertzel 4Hz)").c_str(), r);
+        EXPECT_GT(r.samples_per_sec, rate);
+
+        // BPM by the autocorrelation, read once per second
+        if (sec >= 2) {
+            r = bench(num, [&]() {
+                PulseMonitor monitor(rate, sec);
+                monitor.enableAutocorrelationBPM();
+                float bpm{};
+                for (size_t i = 0; i < num; ++i) {
+                    monitor.push_back(trace.ir[i], trace.red[i]);
+                    monitor.update();
+                    if (i % rate == 0) {
+                        bpm = monitor.bpm();
+                    }
+                }
+                do_not_optimize(bpm);
+            });
+            print_result((prefix + std::to_string(sec) + "s PulseMonitor::update (Autocorrelation)").c_str(), r);
+            EXPECT_GT(r.samples_per_sec, rate);
+        }
+
+        r = bench(num, [&]() {
+            BiquadPulseMonitor monitor(rate, sec);
+            for (size_t i = 0; i < num; ++i) {
+                monitor.push_back(trace.ir[i], trace.red[i]);
+                monitor.update();
+            }
+            do_not_optimize(monitor.bpm());
+        });
+        print_result((prefix + std::to_string(sec) + "s BiquadPulseMonitor::update").c_str(), r);
+        EXPECT_GT(r.samples_per_sec, rate);
+
+        r = bench(num, [&]() {
+            FixedPulseMonitor monitor(rate, sec);
+            for (size_t i = 0; i < num; ++i) {
+                monitor.push_back(trace.raw_ir[i], trace.raw_red[i]);
+                monitor.update();
+            }
+            do_not_optimize(monitor.bpmQ8());
+        });
+        print_result((prefix + std::to_string(sec) + "s FixedPulseMonitor::update").c_str(), r);
+        EXPECT_GT(r.samples_per_sec, rate);
+    }
+}
+
+// N sensors by N PulseMonitor and PulseMonitorBank<N> (cost per sample of a channel)
+template <size_t N>
+void bench_bank(const uint32_t rate, const uint32_t sec)
+{
+    const auto trace = make_trace(rate);
+    const size_t num = trace.ir.size();
+    const std::string prefix{std::to_string(N) + "ch " + std::to_string(rate) + "sps " + std::to_string(sec) + "s "};
+
+    auto r = bench(num * N, [&]() {
+        std::vector<std::unique_ptr<PulseMonitor>> monitors{};
+        for (size_t ch = 0; ch < N; ++ch) {
+            monitors.emplace_back(new PulseMonitor(rate, sec));
+        }
+        for (size_t i = 0; i < num; ++i) {
+            for (auto&& m : monitors) {
+                m->push_back(trace.ir[i], trace.red[i]);
+                m->update();
+            }
+        }
+        do_not_optimize(monitors[0]->bpm());
+    });
+    print_result((prefix + "PulseMonitor x N").c_str(), r);
+    EXPECT_GT(r.samples_per_sec, rate * N);
+
+    r = bench(num * N, [&]() {
+        PulseMonitorBank<N> bank(rate, sec);
+        float ir[N]{}, red[N]{};
+        for (size_t i = 0; i < num; ++i) {
+            std::fill(ir, ir + N, trace.ir[i]);
+            std::fill(red, red + N, trace.red[i]);
+            bank.push_back(ir, red);
+            bank.update();
+        }
+        do_not_optimize(bank.bpm(0));
+    });
+    print_result((prefix + "PulseMonitorBank").c_str(), r);
+    EXPECT_GT(r.samples_per_sec, rate * N);
+}
+
+}  // namespace
+
+TEST(Bench, DSP_Bank)
+{
+    for (auto&& rate : {100U, 400U}) {
+        bench_bank<4>(rate, 5);
+        bench_bank<8>(rate, 5);
+    }
+}
+
+TEST(Bench, DSP_MAX30102)
+{
+    for (auto&& e : max30102_rate_table) {
+        bench_rate("MAX30102", e.rate);
+    }
+}
+
+TEST(Bench, DSP_MAX30100)
+{
+    for (auto&& e : max30100_rate_table) {
+        bench_rate("MAX30100", e.rate);
+    }
+}
@@ -0,0 +1,172 @@
+/*
+ * SPDX-FileCopyrightText: 2026 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  Benchmark for the FIFO read path (update -> read_FIFO) on the register simulators
+  The time includes the cost of the simulator itself, so compare the numbers only between builds of this bench
+*/
+#include <gtest/gtest.h>
+#include <unit/unit_MAX30102.hpp>
+#include <unit/unit_MAX30100.hpp>
+#include "../mock_i2c.hpp"
+#include "../max30102_simulator.hpp"
+#include "../max30100_simulator.hpp"
+#include "../bench_helper.hpp"
+#include <string>
+
+using namespace m5::unit;
+using namespace m5::heart::test;
+
+namespace {
+
+constexpr uint32_t virtual_seconds{10};
+constexpr uint32_t poll_table[] = {0 /* unit interval */, 20, 50, 100};
+
+template <class U, class S>
+void bench_poll(const std::string& label, U& unit, S& sim, const uint32_t depth)
+{
+    const uint32_t rate = sim.samplingRate();
+    uint32_t prev{};
+    for (auto&& p : poll_table) {
+        // Not to fill up (a full FIFO without overflow reads as empty because the pointers are equal)
+        uint32_t poll_ms = p ? p : static_cast<uint32_t>(unit.interval());
+        poll_ms          = std::min<uint32_t>(poll_ms, (depth - 1) * 1000 / rate);
+        if (!poll_ms || poll_ms == prev) {
+            continue;
+        }
+        prev = poll_ms;
+        const uint32_t loops   = virtual_seconds * 1000 / poll_ms;
+        const size_t samples   = static_cast<size_t>(rate) * poll_ms * loops / 1000;
+        uint32_t retrieved_sum = 0;
+        uint64_t wire_sum      = 0;
+        const uint32_t lost    = sim.lost();
+
+        sim.clearStatistics();
+        auto r = bench(
+            samples,
+            [&]() {
+                for (uint32_t i = 0; i < loops; ++i) {
+                    sim.advance(poll_ms * 1000);
+                    unit.update(true);
+                    retrieved_sum += unit.retrieved();
+                    wire_sum += unit.wireBytes();
+                    unit.flush();
+                }
+            },
+            3);
+        auto name = label + " " + std::to_string(rate) + "sps poll " + std::to_string(poll_ms) + "ms";
+        print_result(name.c_str(), r);
+
+        const auto& st = sim.statistics();
+        print_bus(name.c_str(), static_cast<double>(st.transactions) / retrieved_sum,
+                  static_cast<double>(wire_sum) / retrieved_sum);
+        EXPECT_EQ(wire_sum, st.wire_bytes());  // wireBytes() of the unit is the bus traffic
+        EXPECT_EQ(sim.lost(), lost);
+    }
+}
+
+// The caller polls as interval() of the adaptive polling
+template <class U, class S>
+void bench_adaptive(const std::string& label, U& unit, S& sim)
+{
+    ASSERT_TRUE(unit.stopPeriodicMeasurement());
+    ASSERT_TRUE(unit.enableAdaptivePolling());
+    ASSERT_TRUE(unit.startPeriodicMeasurement());
+
+    const uint32_t rate = sim.samplingRate();
+    const uint32_t lost = sim.lost();
+    uint32_t retrieved_sum{};
+    uint64_t wire_sum{};
+
+    sim.clearStatistics();
+    auto r = bench(
+        static_cast<size_t>(rate) * virtual_seconds,
+        [&]() {
+            for (uint32_t ms = 0; ms < virtual_seconds * 1000; ms += unit.interval()) {
+                sim.advance(unit.interval() * 1000);
+                unit.update(true);
+                retrieved_sum += unit.retrieved();
+                wire_sum += unit.wireBytes();
+                unit.flush();
+            }
+        },
+        3);
+    auto name = label + " " + std::to_string(rate) + "sps adaptive";
+    print_result(name.c_str(), r);
+
+    const auto& st = sim.statistics();
+    print_bus(name.c_str(), static_cast<double>(st.transactions) / retrieved_sum,
+              static_cast<double>(wire_sum) / retrieved_sum);
+    EXPECT_EQ(wire_sum, st.wire_bytes());
+    EXPECT_EQ(sim.lost(), lost);
+}
+
+}  // namespace
+
+TEST(Bench, FIFO_MAX30102)
+{
+    using namespace m5::unit::max30102;
+    constexpr Mode mode_table[]     = {Mode::SpO2, Mode::HROnly};
+    constexpr Sampling rate_table[] = {Sampling::Rate100, Sampling::Rate400, Sampling::Rate1000};
+
+    for (auto&& mode : mode_table) {
+        for (auto&& rate : rate_table) {
+            MAX30102Simulator sim{};
+            MockedUnit<UnitMAX30102> unit(sim);
+            auto cfg                  = unit.config();
+            cfg.mode                  = mode;
+            cfg.sampling_rate         = rate;
+            cfg.pulse_width           = LEDPulse::Width69;
+            cfg.fifo_sampling_average = FIFOSampling::Average1;
+            unit.config(cfg);
+            ASSERT_TRUE(unit.begin());
+            bench_poll(mode == Mode::SpO2 ? "MAX30102 SpO2" : "MAX30102 HR  ", unit, sim, MAX_FIFO_DEPTH);
+            bench_adaptive(mode == Mode::SpO2 ? "MAX30102 SpO2" : "MAX30102 HR  ", unit, sim);
+        }
+    }
+}
+
+TEST(Bench, FIFO_MAX30100)
+{
+    using namespace m5::unit::max30100;
+    constexpr Mode mode_table[]     = {Mode::SpO2, Mode::HROnly};
+    constexpr Sampling rate_table[] = {Sampling::Rate100, Sampling::Rate400, Sampling::Rate1000};
+
+    for (auto&& mode : mode_table) {
+        for (auto&& rate : rate_table) {
+            MAX30100Simulator sim{};
+            MockedUnit<UnitMAX30100> unit(sim);
+            auto cfg  = unit.config();
+            cfg.mode  = mode;
+            cfg.rate  = rate;
+            cfg.width = LEDPulse::Width200;
+            unit.config(cfg);
+            ASSERT_TRUE(unit.begin());
+            bench_poll(mode == Mode::SpO2 ? "MAX30100 SpO2" : "MAX30100 HR  ", unit, sim, MAX_FIFO_DEPTH);
+            bench_adaptive(mode == Mode::SpO2 ? "MAX30100 SpO2" : "MAX30100 HR  ", unit, sim);
+        }
+    }
+}
+
+// Transactions per sample by config_t::read_buffer_length (Wire of ESP32 is 128 bytes, the whole FIFO is 192 bytes)
+TEST(Bench, ReadBufferLength)
+{
+    using namespace m5::unit::max30102;
+    constexpr uint16_t length_table[] = {32, 64, 128, 192};
+
+    for (auto&& len : length_table) {
+        MAX30102Simulator sim{};
+        MockedUnit<UnitMAX30102> unit(sim);
+        auto cfg                  = unit.config();
+        cfg.sampling_rate         = Sampling::Rate400;
+        cfg.pulse_width           = LEDPulse::Width69;
+        cfg.fifo_sampling_average = FIFOSampling::Average1;
+        cfg.read_buffer_length    = len;
+        unit.config(cfg);
+        ASSERT_TRUE(unit.begin());
+        EXPECT_EQ(unit.readBufferLength(), len);
+        bench_poll("MAX30102 SpO2 buffer " + std::to_string(len), unit, sim, MAX_FIFO_DEPTH);
+    }
+}
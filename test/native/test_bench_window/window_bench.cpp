@@ -0,0 +1,95 @@
+/*
+ * SPDX-FileCopyrightText: 2026 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  Benchmark for the PulseMonitor window storage (std::deque and rescan vs ring buffer and streaming detector)
+*/
+#include <gtest/gtest.h>
+#include <utility/pulse_monitor.hpp>
+#include "../synthetic_ppg.hpp"
+#include "../legacy_pulse_monitor.hpp"
+#include "../bench_helper.hpp"
+#include <cstdio>
+#include <deque>
+#include <string>
+
+using namespace m5::heart;
+using namespace m5::heart::test;
+
+namespace {
+constexpr uint32_t rate_table[] = {100, 400};
+constexpr uint32_t sec_table[]  = {2, 5};
+constexpr float trace_seconds{30.f};
+}  // namespace
+
+TEST(Bench, WindowStorage)
+{
+    for (auto&& rate : rate_table) {
+        for (auto&& sec : sec_table) {
+            const size_t window = rate * sec;
+            auto trace          = make_ppg(rate, trace_seconds);
+
+            // Before: std::deque with push_back/pop_front per sample
+            auto before = bench(trace.size(), [&]() {
+                std::deque<float> dq;
+                for (auto&& s : trace) {
+                    dq.push_back(static_cast<float>(s.ir));
+                    if (dq.size() > window) {
+                        dq.pop_front();
+                    }
+                }
+                do_not_optimize(dq.back());
+            });
+            // After: contiguous ring buffer allocated once
+            auto after = bench(trace.size(), [&]() {
+                m5::container::CircularBuffer<float> rb(window);
+                for (auto&& s : trace) {
+                    rb.push_back(static_cast<float>(s.ir));
+                }
+                do_not_optimize(rb[rb.size() - 1]);
+            });
+            auto label = std::to_string(rate) + "sps/" + std::to_string(sec) + "s";
+            print_result(("window deque      " + label).c_str(), before);
+            print_result(("window ring       " + label).c_str(), after);
+        }
+    }
+}
+
+TEST(Bench, PushBackAndUpdate)
+{
+    for (auto&& rate : rate_table) {
+        for (auto&& sec : sec_table) {
+            auto trace = make_ppg(rate, trace_seconds);
+
+            // Before: deque window and whole window rescan on each update
+            auto before = bench(
+                trace.size(),
+                [&]() {
+                    LegacyMonitor m(rate, sec);
+                    for (auto&& s : trace) {
+                        m.push_back(s.ir);
+                        m.update();
+                    }
+                    do_not_optimize(m._bpm);
+                },
+                1);
+            // After
+            auto after = bench(trace.size(), [&]() {
+                PulseMonitor m(rate, sec);
+                for (auto&& s : trace) {
+                    m.push_back(s.ir);
+                    m.update();
+                }
+                do_not_optimize(m.bpm());
+            });
+            auto label = std::to_string(rate) + "sps/" + std::to_string(sec) + "s";
+            print_result(("monitor legacy    " + label).c_str(), before);
+            print_result(("monitor current   " + label).c_str(), after);
+            // Wall-clock timings are not compared (flaky on the shared runners), the ratio is reported instead
+            std::printf("[BENCH] %-48s %10.2fx\n", ("monitor speedup   " + label).c_str(),
+                        after.ns_per_sample > 0.0 ? before.ns_per_sample / after.ns_per_sample : 0.0);
+        }
+    }
+}
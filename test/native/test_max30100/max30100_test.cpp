@@ -0,0 +1,544 @@
+/*
+ * SPDX-FileCopyrightText: 2026 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for UnitMAX30100 on the register simulator
+*/
+#include <gtest/gtest.h>
+#include <unit/unit_MAX30100.hpp>
+#include "../mock_i2c.hpp"
+#include "../max30100_simulator.hpp"
+#include <memory>
+#include <string>
+
+using namespace m5::unit;
+using namespace m5::unit::max30100;
+using namespace m5::heart::test;
+
+namespace {
+
+// The value tells the sample index and the LED
+uint32_t index_generator(const uint32_t index, const uint32_t, const uint8_t led, void*)
+{
+    return ((index << 2) | led) & 0xFFFF;
+}
+inline uint16_t expected(const uint32_t index, const uint8_t led)
+{
+    return index_generator(index, 0, led, nullptr);
+}
+
+// The INT pin of the simulator
+bool int_pin(void* arg)
+{
+    return static_cast<MAX30100Simulator*>(arg)->interrupt();
+}
+
+constexpr uint32_t sampling_rate_table[] = {50, 100, 167, 200, 400, 600, 800, 1000};
+
+}  // namespace
+
+class TestMAX30100 : public ::testing::Test {
+protected:
+    virtual void SetUp() override
+    {
+        sim.setGenerator(index_generator);
+        unit.reset(new MockedUnit<UnitMAX30100>(sim));
+        ASSERT_TRUE(unit->begin());
+        ASSERT_TRUE(unit->inPeriodic());
+        sim.clearStatistics();
+    }
+
+    void restart(const Mode mode = Mode::SpO2, const Sampling rate = Sampling::Rate100)
+    {
+        ASSERT_TRUE(unit->stopPeriodicMeasurement());
+        ASSERT_TRUE(unit->startPeriodicMeasurement(mode, rate, LEDPulse::Width200, LED::Current27_1, false,
+                                                   LED::Current27_1));
+        base = sim.generated();
+    }
+
+    MAX30100Simulator sim{};
+    std::unique_ptr<MockedUnit<UnitMAX30100>> unit{};
+    uint32_t base{};  // Index of the first sample after restart
+};
+
+TEST_F(TestMAX30100, Begin)
+{
+    EXPECT_EQ(sim.peek(MAX30100Simulator::MODE_CONFIG) & 0x07, 0x03);  // SpO2
+    EXPECT_EQ(unit->calculateSamplingRate(), sim.samplingRate());
+    EXPECT_EQ(sim.samplingRate(), 100U);
+
+    uint8_t rev{};
+    EXPECT_TRUE(unit->readRevisionID(rev));
+    EXPECT_EQ(rev, sim.peek(MAX30100Simulator::REVISION_ID));
+
+    MAX30100Simulator broken{};
+    broken.setFailure(true);
+    MockedUnit<UnitMAX30100> u(broken);
+    EXPECT_FALSE(u.begin());
+}
+
+TEST_F(TestMAX30100, Periodic)
+{
+    restart();
+
+    // 10 samples (not overflow)
+    sim.advance(100 * 1000);
+    unit->update(true);
+    EXPECT_TRUE(unit->updated());
+    EXPECT_EQ(unit->retrieved(), 10U);
+    EXPECT_EQ(unit->available(), 10U);
+    EXPECT_EQ(unit->overflow(), 0U);
+
+    uint32_t idx = base;
+    while (unit->available()) {
+        EXPECT_EQ(unit->ir(), expected(idx, 2));
+        EXPECT_EQ(unit->red(), expected(idx, 1));
+        unit->discard();
+        ++idx;
+    }
+
+    // Nothing new
+    unit->update(true);
+    EXPECT_FALSE(unit->updated());
+    EXPECT_EQ(unit->retrieved(), 0U);
+
+    // 40 samples (overflow!)
+    sim.advance(400 * 1000);
+    unit->update(true);
+    EXPECT_TRUE(unit->updated());
+    EXPECT_EQ(unit->retrieved(), MAX_FIFO_DEPTH);
+    EXPECT_EQ(unit->available(), MAX_FIFO_DEPTH);
+    EXPECT_EQ(unit->overflow(), MAX_FIFO_DEPTH - 1);  // Saturated
+    EXPECT_EQ(sim.lost(), 40U - MAX_FIFO_DEPTH);
+
+    // No roll over, so the oldest 16 remain
+    idx = base + 10;
+    while (unit->available()) {
+        EXPECT_EQ(unit->ir(), expected(idx, 2));
+        unit->discard();
+        ++idx;
+    }
+
+    // Counter is cleared by reading
+    sim.advance(10 * 1000);
+    unit->update(true);
+    EXPECT_EQ(unit->retrieved(), 1U);
+    EXPECT_EQ(unit->overflow(), 0U);
+}
+
+TEST_F(TestMAX30100, HROnly)
+{
+    restart(Mode::HROnly);
+
+    sim.advance(100 * 1000);
+    unit->update(true);
+    EXPECT_EQ(unit->retrieved(), 10U);
+    uint32_t idx = base;
+    while (unit->available()) {
+        EXPECT_EQ(unit->ir(), expected(idx, 2));
+        EXPECT_EQ(unit->red(), 0U);
+        unit->discard();
+        ++idx;
+    }
+}
+
+TEST_F(TestMAX30100, SamplingRate)
+{
+    for (uint8_t r = 0; r < 8; ++r) {
+        const auto rate = static_cast<Sampling>(r);
+        SCOPED_TRACE(std::to_string(sampling_rate_table[r]));
+
+        restart(Mode::HROnly, rate);
+        unit->flush();
+
+        // Poll often enough not to overflow
+        uint32_t count{};
+        for (uint32_t ms = 0; ms < 1000; ms += 5) {
+            sim.advance(5 * 1000);
+            unit->update(true);
+            count += unit->retrieved();
+            EXPECT_EQ(unit->overflow(), 0U);
+            unit->flush();
+        }
+        EXPECT_EQ(count, sampling_rate_table[r]);
+        EXPECT_EQ(sim.lost(), 0U);
+    }
+}
+
+TEST_F(TestMAX30100, Temperature)
+{
+    constexpr float table[] = {36.5f, 25.0f, -5.25f, 0.0625f, 85.0f};
+    for (auto&& c : table) {
+        sim.setTemperature(c);
+        TemperatureData td{};
+        EXPECT_TRUE(unit->measureTemperatureSingleshot(td));
+        EXPECT_FLOAT_EQ(td.celsius(), c);
+    }
+}
+
+TEST_F(TestMAX30100, BusError)
+{
+    sim.advance(100 * 1000);
+    sim.setFailure(true);
+    unit->update(true);
+    EXPECT_FALSE(unit->updated());
+    EXPECT_EQ(unit->available(), 0U);
+
+    // The samples are still in the FIFO
+    sim.setFailure(false);
+    unit->update(true);
+    EXPECT_TRUE(unit->updated());
+    EXPECT_EQ(unit->retrieved(), 10U);
+}
+
+TEST_F(TestMAX30100, Transactions)
+{
+    restart();
+    sim.clearStatistics();
+
+    sim.advance(100 * 1000);  // 10 samples 40 bytes
+    unit->update(true);
+    EXPECT_EQ(unit->retrieved(), 10U);
+
+    auto& st = sim.statistics();
+    // Pointers and counter:write register + burst read, FIFO_DATA:write register + 2 reads (32 + 8 bytes)
+    EXPECT_EQ(st.transactions, 2U + 1U + 2U);
+    EXPECT_EQ(st.read_bytes, 3U + 40U);
+    // The register addresses are followed by the repeated START
+    EXPECT_EQ(st.repeated_starts, 2U);
+    // Address byte of each transaction, register addresses and data
+    EXPECT_EQ(unit->wireBytes(), st.wire_bytes());
+    EXPECT_EQ(unit->wireBytes(), 5U + 2U + 3U + 40U);
+}
+
+TEST_F(TestMAX30100, ReadBufferLength)
+{
+    EXPECT_EQ(unit->readBufferLength(), 32U);  // Default of the platform
+
+    // Clamped to the whole FIFO
+    auto cfg               = unit->config();
+    cfg.read_buffer_length = 1024;
+    unit->config(cfg);
+    ASSERT_TRUE(unit->begin());
+    EXPECT_EQ(unit->readBufferLength(), 64U);
+
+    // 10 samples in one read
+    restart();
+    sim.clearStatistics();
+    sim.advance(100 * 1000);
+    unit->update(true);
+    EXPECT_EQ(unit->retrieved(), 10U);
+    auto& st = sim.statistics();
+    EXPECT_EQ(st.transactions, 2U + 1U + 1U);
+    EXPECT_EQ(unit->wireBytes(), st.wire_bytes());
+}
+
+TEST_F(TestMAX30100, AsyncRead)
+{
+    MockAsyncI2C bus(sim);
+    bus.setCallback([](const bool ok, void* arg) { static_cast<UnitMAX30100*>(arg)->completeAsyncRead(ok); },
+                    unit.get());
+
+    EXPECT_FALSE(unit->enableAsyncRead(MockAsyncI2C::start, &bus));  // In periodic
+    ASSERT_TRUE(unit->stopPeriodicMeasurement());
+    EXPECT_FALSE(unit->enableAsyncRead(nullptr));
+    ASSERT_TRUE(unit->enableAsyncRead(MockAsyncI2C::start, &bus));
+    EXPECT_TRUE(unit->inAsyncRead());
+    restart();
+
+    // update() returns after reading the pointers
+    sim.clearStatistics();
+    sim.advance(100 * 1000);
+    unit->update(true);
+    EXPECT_TRUE(unit->transferring());
+    EXPECT_FALSE(unit->updated());
+    EXPECT_TRUE(unit->retrievedData().empty());
+    EXPECT_EQ(sim.statistics().transactions, 2U);
+    EXPECT_FALSE(unit->stopPeriodicMeasurement());  // Transferring
+
+    // 50us + (3 + 40) bytes * 22.5us
+    bus.advance(2000);
+    unit->update(true);
+    EXPECT_TRUE(unit->updated());
+    EXPECT_FALSE(unit->transferring());
+    EXPECT_EQ(unit->retrieved(), 10U);
+    EXPECT_EQ(unit->wireBytes(), sim.statistics().wire_bytes());
+    uint32_t idx = base;
+    for (auto&& d : unit->retrievedData()) {
+        EXPECT_EQ(d.ir(), expected(idx, 2));
+        EXPECT_EQ(d.red(), expected(idx, 1));
+        ++idx;
+    }
+
+    ASSERT_TRUE(unit->stopPeriodicMeasurement());
+    EXPECT_TRUE(unit->disableAsyncRead());
+    EXPECT_FALSE(unit->inAsyncRead());
+}
+
+TEST_F(TestMAX30100, AsyncReadCancel)
+{
+    MockAsyncI2C bus(sim);
+    bus.setCallback([](const bool ok, void* arg) { static_cast<UnitMAX30100*>(arg)->completeAsyncRead(ok); },
+                    unit.get());
+    struct Pin {
+        MAX30100Simulator* sim;
+        uint32_t calls;
+    } pin{&sim, 0};
+    auto counted_pin = [](void* arg) -> bool {
+        auto p = static_cast<Pin*>(arg);
+        ++p->calls;
+        return p->sim->interrupt();
+    };
+
+    ASSERT_TRUE(unit->stopPeriodicMeasurement());
+    ASSERT_TRUE(unit->enableAsyncRead(MockAsyncI2C::start, &bus));
+    ASSERT_TRUE(unit->enableInterruptMode(counted_pin, &pin));
+    restart();
+    EXPECT_FALSE(unit->cancelAsyncRead());  // Not transferring
+
+    // The data ready function is not called while transferring
+    while (!sim.interrupt()) {
+        sim.advance(1000);
+    }
+    unit->update();
+    ASSERT_TRUE(unit->transferring());
+    const uint32_t calls = pin.calls;
+    for (uint32_t ms = 0; ms < 10; ++ms) {
+        sim.advance(1000);
+        unit->update();
+    }
+    EXPECT_EQ(pin.calls, calls);
+    EXPECT_TRUE(unit->transferring());
+
+    // Abandon the transfer that does not complete
+    bus.cancel();
+    EXPECT_TRUE(unit->cancelAsyncRead());
+    EXPECT_FALSE(unit->transferring());
+    EXPECT_EQ(sim.unread(), 0U);
+    unit->completeAsyncRead();  // Notified after the cancel
+    EXPECT_FALSE(unit->poll());
+    EXPECT_FALSE(unit->updated());
+
+    // The discarded samples are the gap of the next read
+    while (!sim.interrupt()) {
+        sim.advance(1000);
+    }
+    unit->update();
+    ASSERT_TRUE(unit->transferring());
+    bus.advance(10 * 1000);
+    EXPECT_TRUE(unit->poll());
+    EXPECT_GT(unit->retrieved(), 0U);
+    EXPECT_EQ(unit->gap(), unit->sampleIndex());
+    EXPECT_EQ(unit->retrievedData()[0].ir(), expected(base + unit->sampleIndex(), 2));
+
+    ASSERT_TRUE(unit->stopPeriodicMeasurement());
+    EXPECT_TRUE(unit->disableInterruptMode());
+    EXPECT_TRUE(unit->disableAsyncRead());
+}
+
+TEST_F(TestMAX30100, Timeline)
+{
+    restart();
+    EXPECT_EQ(unit->samplePeriod(), 10000U);  // 100 sps
+
+    sim.advance(100 * 1000);
+    unit->update(true);
+    const uint32_t now = sim.now();
+    EXPECT_EQ(unit->retrieved(), 10U);
+    EXPECT_EQ(unit->gap(), 0U);
+    EXPECT_EQ(unit->sampleIndex(), 0U);
+    // The newest is at the read
+    EXPECT_EQ(unit->timestamp() + 9 * unit->samplePeriod(), now);
+
+    // Overflow, the new samples are lost while the FIFO is full
+    sim.advance(24 * 10 * 1000);
+    unit->update(true);
+    const uint32_t at = sim.now();
+    EXPECT_EQ(unit->retrieved(), 16U);
+    EXPECT_EQ(unit->overflow(), 8U);
+    EXPECT_EQ(unit->gap(), 0U);
+    EXPECT_EQ(unit->sampleIndex(), 10U);
+    EXPECT_EQ(unit->retrievedData()[0].ir(), expected(base + unit->sampleIndex(), 2));
+    EXPECT_EQ(unit->timestamp() + (15 + 8) * unit->samplePeriod(), at);
+
+    // The lost samples are the gap of the next batch
+    sim.advance(50 * 1000);
+    unit->update(true);
+    EXPECT_EQ(unit->gap(), 8U);
+    EXPECT_EQ(unit->sampleIndex(), 10U + 16U + 8U);
+
+    // The overflow counter saturates
+    sim.advance(1000 * 1000);
+    unit->update(true);
+    EXPECT_EQ(unit->overflow(), 15U);
+    sim.advance(50 * 1000);
+    unit->update(true);
+    EXPECT_GE(unit->gap(), 15U);
+}
+
+TEST_F(TestMAX30100, InterruptMode)
+{
+    EXPECT_FALSE(unit->enableInterruptMode(int_pin, &sim));  // In periodic
+    ASSERT_TRUE(unit->stopPeriodicMeasurement());
+    ASSERT_TRUE(unit->enableInterruptMode(int_pin, &sim));
+    EXPECT_TRUE(unit->inInterruptMode());
+
+    // The interrupt enable by the user is kept
+    constexpr uint8_t TEMP_RDY{MAX30100Simulator::INT_TEMP_RDY};
+    ASSERT_TRUE(unit->writeRegister8(MAX30100Simulator::INT_ENABLE, TEMP_RDY));
+
+    restart();
+    EXPECT_EQ(sim.peek(MAX30100Simulator::INT_ENABLE), MAX30100Simulator::INT_A_FULL | TEMP_RDY);
+
+    // No bus access until the interrupt
+    sim.clearStatistics();
+    sim.advance(100 * 1000);
+    unit->update();
+    EXPECT_FALSE(unit->updated());
+    EXPECT_EQ(sim.statistics().transactions, 0U);
+
+    // One read drains a batch on each interrupt
+    uint32_t idx = base, batches{};
+    for (uint32_t ms = 0; ms < 10 * 1000; ++ms) {
+        sim.advance(1000);
+        unit->update();
+        if (unit->updated()) {
+            ++batches;
+            EXPECT_EQ(unit->retrieved(), MAX_FIFO_DEPTH - 1);
+            EXPECT_FALSE(sim.interrupt());
+            while (unit->available()) {
+                EXPECT_EQ(unit->ir(), expected(idx, 2));
+                unit->discard();
+                ++idx;
+            }
+        }
+    }
+    EXPECT_EQ(batches, (sim.generated() - base) / (MAX_FIFO_DEPTH - 1));
+    EXPECT_EQ(idx + sim.unread(), sim.generated());
+    EXPECT_EQ(sim.lost(), 0U);
+
+    ASSERT_TRUE(unit->stopPeriodicMeasurement());
+    ASSERT_TRUE(unit->disableInterruptMode());
+    EXPECT_EQ(sim.peek(MAX30100Simulator::INT_ENABLE), TEMP_RDY);
+    restart();
+    EXPECT_EQ(sim.peek(MAX30100Simulator::INT_ENABLE), TEMP_RDY);
+}
+
+TEST_F(TestMAX30100, InterruptNotify)
+{
+    ASSERT_TRUE(unit->stopPeriodicMeasurement());
+    ASSERT_TRUE(unit->enableInterruptMode());
+    restart();
+
+    // Just full without overflow (the pointers are equal)
+    sim.advance(MAX_FIFO_DEPTH * 10 * 1000);
+    EXPECT_TRUE(sim.interrupt());
+    unit->update();
+    EXPECT_FALSE(unit->updated());  // Not notified
+
+    unit->notifyInterrupt();
+    unit->update();
+    EXPECT_TRUE(unit->updated());
+    EXPECT_EQ(unit->retrieved(), MAX_FIFO_DEPTH);
+    EXPECT_EQ(unit->overflow(), 0U);
+    EXPECT_FALSE(sim.interrupt());
+
+    uint8_t status{};
+    sim.advance(10 * 1000);
+    EXPECT_TRUE(unit->readInterruptStatus(status));
+    EXPECT_TRUE(status & MAX30100Simulator::INT_SPO2_RDY);
+    EXPECT_TRUE(unit->readInterruptStatus(status));
+    EXPECT_EQ(status, 0U);
+}
+
+TEST_F(TestMAX30100, AdaptivePolling)
+{
+    EXPECT_FALSE(unit->enableAdaptivePolling(0));
+    EXPECT_FALSE(unit->enableAdaptivePolling(MAX_FIFO_DEPTH));
+    ASSERT_TRUE(unit->enableAdaptivePolling());
+    EXPECT_TRUE(unit->inAdaptivePolling());
+    const uint8_t target = unit->adaptivePollingTarget();
+    EXPECT_EQ(target, MAX_FIFO_DEPTH * 3 / 4);
+
+    constexpr Sampling rate_table[] = {Sampling::Rate100, Sampling::Rate167, Sampling::Rate400, Sampling::Rate1000};
+    for (auto&& rate : rate_table) {
+        SCOPED_TRACE(std::to_string(m5::stl::to_underlying(rate)));
+        restart(Mode::HROnly, rate);
+        const uint32_t lost = sim.lost();
+
+        // The caller polls as interval()
+        uint32_t polls{}, count{};
+        for (uint32_t ms = 0; ms < 10 * 1000; ms += unit->interval()) {
+            sim.advance(unit->interval() * 1000);
+            unit->update(true);
+            EXPECT_EQ(unit->overflow(), 0U);
+            if (ms >= 5 * 1000) {
+                count += unit->retrieved();
+                ++polls;
+            }
+            unit->flush();
+        }
+        EXPECT_EQ(sim.lost(), lost);
+        // Converged around the target
+        ASSERT_NE(polls, 0U);
+        EXPECT_GE(count / polls, target * 3U / 4U);
+        EXPECT_LE(count / polls, MAX_FIFO_DEPTH - 1U);
+
+        // Not narrowed by the loss of a late poll (the caller is the limit, not the interval)
+        const auto prev = unit->interval();
+        sim.advance(prev * 2 * 1000);
+        unit->update(true);
+        EXPECT_NE(unit->overflow(), 0U);
+        EXPECT_EQ(unit->interval(), prev);
+        unit->flush();
+    }
+
+    // The caller polls slower than interval(), the interval keeps the time to reach the target
+    ASSERT_TRUE(unit->stopPeriodicMeasurement());
+    ASSERT_TRUE(unit->enableAdaptivePolling(MAX_FIFO_DEPTH / 4));
+    restart(Mode::HROnly, Sampling::Rate100);
+    const uint32_t fill = MAX_FIFO_DEPTH / 4 * 10;  // ms at 100 sps
+    for (uint32_t i = 0; i < 20; ++i) {
+        sim.advance(fill * 3 * 1000);
+        unit->update(true);
+        EXPECT_EQ(unit->overflow(), 0U);
+        unit->flush();
+    }
+    EXPECT_GE(unit->interval(), fill * 3 / 4);
+    EXPECT_LE(unit->interval(), fill);
+
+    unit->disableAdaptivePolling();
+    EXPECT_FALSE(unit->inAdaptivePolling());
+    EXPECT_EQ(unit->interval(), 10U);  // 100 sps
+}
+
+TEST_F(TestMAX30100, RetrievedData)
+{
+    restart();
+    EXPECT_TRUE(unit->retrievedData().empty());
+
+    uint32_t idx = base;
+    for (uint32_t n = 1; n <= MAX_FIFO_DEPTH - 1; n += 7) {
+        sim.advance(n * 10 * 1000);
+        unit->update(true);
+        ASSERT_EQ(unit->retrieved(), n);
+
+        auto batch = unit->retrievedData();
+        ASSERT_EQ(batch.size(), n);
+        // Same as the stored data
+        EXPECT_EQ(unit->available(), n);
+        for (auto&& d : batch) {
+            EXPECT_EQ(d.ir(), expected(idx, 2));
+            EXPECT_EQ(d.red(), expected(idx, 1));
+            EXPECT_EQ(d.ir(), unit->ir());
+            unit->discard();
+            ++idx;
+        }
+    }
+
+    // Nothing new
+    unit->update(true);
+    EXPECT_TRUE(unit->retrievedData().empty());
+}
@@ -0,0 +1,786 @@
+/*
+ * SPDX-FileCopyrightText: 2026 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for UnitMAX30102 on the register simulator
+*/
+#include <gtest/gtest.h>
+#include <unit/unit_MAX30102.hpp>
+#include "../mock_i2c.hpp"
+#include "../max30102_simulator.hpp"
+#include <memory>
+#include <string>
+#include <tuple>
+
+using namespace m5::unit;
+using namespace m5::unit::max30102;
+using namespace m5::heart::test;
+
+namespace {
+
+constexpr uint32_t fifo_data_mask{0x3FFFF};
+
+// The value tells the sample index and the LED
+uint32_t index_generator(const uint32_t index, const uint32_t, const uint8_t led, void*)
+{
+    return ((index << 2) | led) & fifo_data_mask;
+}
+inline uint32_t expected(const uint32_t index, const uint8_t led)
+{
+    return index_generator(index, 0, led, nullptr);
+}
+
+// The INT pin of the simulator
+bool int_pin(void* arg)
+{
+    return static_cast<MAX30102Simulator*>(arg)->interrupt();
+}
+
+constexpr uint32_t sampling_rate_table[] = {50, 100, 200, 400, 800, 1000, 1600, 3200};
+constexpr uint32_t average_table[]       = {1, 2, 4, 8, 16, 32};
+
+}  // namespace
+
+class TestMAX30102 : public ::testing::Test {
+protected:
+    virtual void SetUp() override
+    {
+        sim.setGenerator(index_generator);
+        unit.reset(new MockedUnit<UnitMAX30102>(sim));
+        ASSERT_TRUE(unit->begin());
+        ASSERT_TRUE(unit->inPeriodic());
+        sim.clearStatistics();
+    }
+
+    // Restart in SpO2 100 sps without averaging
+    void restart(const Mode mode = Mode::SpO2, const Sampling rate = Sampling::Rate100,
+                 const FIFOSampling avg = FIFOSampling::Average1)
+    {
+        ASSERT_TRUE(unit->stopPeriodicMeasurement());
+        ASSERT_TRUE(unit->startPeriodicMeasurement(mode, ADC::Range4096nA, rate, LEDPulse::Width69, avg, 0x1F, 0x1F));
+        base = sim.generated();
+    }
+
+    MAX30102Simulator sim{};
+    std::unique_ptr<MockedUnit<UnitMAX30102>> unit{};
+    uint32_t base{};  // Index of the first sample after restart
+};
+
+TEST_F(TestMAX30102, Begin)
+{
+    EXPECT_EQ(sim.peek(MAX30102Simulator::MODE_CONFIG) & 0x07, 0x03);  // SpO2
+    EXPECT_EQ(unit->calculateSamplingRate(), sim.samplingRate());
+    EXPECT_EQ(sim.samplingRate(), 100U);  // 400 sps / 4
+
+    uint8_t rev{};
+    EXPECT_TRUE(unit->readRevisionID(rev));
+    EXPECT_EQ(rev, sim.peek(MAX30102Simulator::REVISION_ID));
+
+    MAX30102Simulator broken{};
+    broken.setFailure(true);
+    MockedUnit<UnitMAX30102> u(broken);
+    EXPECT_FALSE(u.begin());
+}
+
+TEST_F(TestMAX30102, Periodic)
+{
+    restart();
+
+    // 10 samples (not overflow)
+    sim.advance(100 * 1000);
+    unit->update(true);
+    EXPECT_TRUE(unit->updated());
+    EXPECT_EQ(unit->retrieved(), 10U);
+    EXPECT_EQ(unit->available(), 10U);
+    EXPECT_EQ(unit->overflow(), 0U);
+
+    uint32_t idx = base;
+    while (unit->available()) {
+        EXPECT_EQ(unit->ir(), expected(idx, 2));
+        EXPECT_EQ(unit->red(), expected(idx, 1));
+        unit->discard();
+        ++idx;
+    }
+
+    // Nothing new
+    unit->update(true);
+    EXPECT_FALSE(unit->updated());
+    EXPECT_EQ(unit->retrieved(), 0U);
+
+    // 40 samples (overflow!)
+    sim.advance(400 * 1000);
+    unit->update(true);
+    EXPECT_TRUE(unit->updated());
+    EXPECT_EQ(unit->retrieved(), MAX_FIFO_DEPTH);
+    EXPECT_EQ(unit->available(), MAX_FIFO_DEPTH);
+    EXPECT_EQ(unit->overflow(), 40U - MAX_FIFO_DEPTH);
+    EXPECT_EQ(sim.lost(), 40U - MAX_FIFO_DEPTH);
+
+    // Rolled over, so the latest 32 remain
+    idx = base + 10 + 40 - MAX_FIFO_DEPTH;
+    while (unit->available()) {
+        EXPECT_EQ(unit->ir(), expected(idx, 2));
+        unit->discard();
+        ++idx;
+    }
+    EXPECT_EQ(idx, sim.generated());
+
+    // Counter is cleared by reading
+    sim.advance(10 * 1000);
+    unit->update(true);
+    EXPECT_EQ(unit->retrieved(), 1U);
+    EXPECT_EQ(unit->overflow(), 0U);
+
+    // Saturated
+    unit->flush();
+    sim.advance(1000 * 1000);
+    unit->update(true);
+    EXPECT_EQ(unit->retrieved(), MAX_FIFO_DEPTH);
+    EXPECT_EQ(unit->overflow(), MAX_FIFO_DEPTH - 1);
+}
+
+TEST_F(TestMAX30102, HROnly)
+{
+    restart(Mode::HROnly);
+
+    sim.advance(200 * 1000);
+    unit->update(true);
+    EXPECT_EQ(unit->retrieved(), 20U);
+    uint32_t idx = base;
+    while (unit->available()) {
+        EXPECT_EQ(unit->ir(), expected(idx, 1));  // The single channel (Red LED) is exposed via ir()
+        EXPECT_EQ(unit->red(), 0U);
+        unit->discard();
+        ++idx;
+    }
+}
+
+TEST_F(TestMAX30102, MultiLED)
+{
+    constexpr std::tuple<Slot, Slot> cond_table[] = {
+        {Slot::IR, Slot::Red},
+        {Slot::Red, Slot::IR},
+        {Slot::IR, Slot::None},
+        {Slot::Red, Slot::None},
+    };
+
+    for (auto&& cond : cond_table) {
+        Slot slot1{}, slot2{};
+        std::tie(slot1, slot2) = cond;
+        SCOPED_TRACE(std::to_string(m5::stl::to_underlying(slot1)) + "/" +
+                     std::to_string(m5::stl::to_underlying(slot2)));
+
+        EXPECT_TRUE(unit->stopPeriodicMeasurement());
+        EXPECT_TRUE(unit->writeMode(Mode::MultiLED));
+        EXPECT_TRUE(unit->writeSpO2Configuration(ADC::Range4096nA, Sampling::Rate100, LEDPulse::Width411));
+        EXPECT_TRUE(unit->writeFIFOConfiguration(FIFOSampling::Average1, true, 15));
+        EXPECT_TRUE(unit->writeMultiLEDModeControl(slot1, slot2));
+        EXPECT_TRUE(unit->startPeriodicMeasurement());
+        unit->flush();
+        const uint32_t first = sim.generated();
+
+        sim.advance(150 * 1000);
+        unit->update(true);
+        EXPECT_EQ(unit->retrieved(), 15U);
+        uint32_t idx = first;
+        while (unit->available()) {
+            const bool has_ir  = (slot1 == Slot::IR || slot2 == Slot::IR);
+            const bool has_red = (slot1 == Slot::Red || slot2 == Slot::Red);
+            EXPECT_EQ(unit->ir(), has_ir ? expected(idx, 2) : 0U);
+            EXPECT_EQ(unit->red(), has_red ? expected(idx, 1) : 0U);
+            unit->discard();
+            ++idx;
+        }
+    }
+}
+
+TEST_F(TestMAX30102, SamplingRate)
+{
+    for (uint8_t r = 0; r < 8; ++r) {
+        for (uint8_t a = 0; a < 6; ++a) {
+            const auto rate = static_cast<Sampling>(r);
+            const auto avg  = static_cast<FIFOSampling>(a);
+            const uint32_t sps{sampling_rate_table[r] / average_table[a]};
+            SCOPED_TRACE(std::to_string(sampling_rate_table[r]) + "/" + std::to_string(average_table[a]));
+
+            restart(Mode::HROnly, rate, avg);
+            unit->flush();
+
+            // Poll often enough not to overflow
+            uint32_t count{};
+            for (uint32_t ms = 0; ms < 1000; ms += 5) {
+                sim.advance(5 * 1000);
+                unit->update(true);
+                count += unit->retrieved();
+                EXPECT_EQ(unit->overflow(), 0U);
+                unit->flush();
+            }
+            EXPECT_EQ(count, sps);
+            EXPECT_EQ(sim.lost(), 0U);
+        }
+    }
+}
+
+TEST_F(TestMAX30102, Temperature)
+{
+    constexpr float table[] = {36.5f, 25.0f, -5.25f, 0.0625f, 85.0f};
+    for (auto&& c : table) {
+        sim.setTemperature(c);
+        TemperatureData td{};
+        EXPECT_TRUE(unit->measureTemperatureSingleshot(td));
+        EXPECT_FLOAT_EQ(td.celsius(), c);
+    }
+}
+
+TEST_F(TestMAX30102, BusError)
+{
+    sim.advance(100 * 1000);
+    sim.setFailure(true);
+    unit->update(true);
+    EXPECT_FALSE(unit->updated());
+    EXPECT_EQ(unit->available(), 0U);
+
+    // The samples are still in the FIFO
+    sim.setFailure(false);
+    unit->update(true);
+    EXPECT_TRUE(unit->updated());
+    EXPECT_EQ(unit->retrieved(), 10U);
+}
+
+TEST_F(TestMAX30102, Transactions)
+{
+    restart();
+    sim.clearStatistics();
+
+    sim.advance(100 * 1000);  // 10 samples 60 bytes
+    unit->update(true);
+    EXPECT_EQ(unit->retrieved(), 10U);
+
+    auto& st = sim.statistics();
+    // Pointers and counter:write register + burst read, FIFO_DATA:write register + 2 reads (30 bytes each)
+    EXPECT_EQ(st.transactions, 2U + 1U + 2U);
+    EXPECT_EQ(st.read_bytes, 3U + 60U);
+    // The register addresses are followed by the repeated START
+    EXPECT_EQ(st.repeated_starts, 2U);
+    // Address byte of each transaction, register addresses and data
+    EXPECT_EQ(unit->wireBytes(), st.wire_bytes());
+    EXPECT_EQ(unit->wireBytes(), 5U + 2U + 3U + 60U);
+
+    // Full FIFO, 7 reads (30 bytes * 6 + 6 bytes), decoded in place
+    sim.clearStatistics();
+    sim.advance(310 * 1000);
+    unit->update(true);
+    EXPECT_EQ(unit->retrieved(), 31U);
+    EXPECT_EQ(st.transactions, 2U + 1U + 7U);
+    EXPECT_EQ(unit->wireBytes(), st.wire_bytes());
+    uint32_t idx = base + 10;
+    for (auto&& d : unit->retrievedData()) {
+        EXPECT_EQ(d.ir(), expected(idx, 2));
+        EXPECT_EQ(d.red(), expected(idx, 1));
+        ++idx;
+    }
+}
+
+TEST_F(TestMAX30102, ReadBufferLength)
+{
+    EXPECT_EQ(unit->readBufferLength(), 32U);  // Default of the platform
+
+    // Clamped to the whole FIFO
+    auto cfg               = unit->config();
+    cfg.read_buffer_length = 1024;
+    unit->config(cfg);
+    ASSERT_TRUE(unit->begin());
+    EXPECT_EQ(unit->readBufferLength(), 192U);
+
+    // Full FIFO in one read
+    restart();
+    sim.clearStatistics();
+    sim.advance(310 * 1000);
+    unit->update(true);
+    EXPECT_EQ(unit->retrieved(), 31U);
+    auto& st = sim.statistics();
+    EXPECT_EQ(st.transactions, 2U + 1U + 1U);
+    EXPECT_EQ(unit->wireBytes(), st.wire_bytes());
+    uint32_t idx = base;
+    for (auto&& d : unit->retrievedData()) {
+        EXPECT_EQ(d.ir(), expected(idx, 2));
+        EXPECT_EQ(d.red(), expected(idx, 1));
+        ++idx;
+    }
+
+    // Less than a sample is a sample
+    cfg.read_buffer_length = 4;
+    unit->config(cfg);
+    ASSERT_TRUE(unit->begin());
+    restart();
+    sim.clearStatistics();
+    sim.advance(30 * 1000);
+    unit->update(true);
+    EXPECT_EQ(unit->retrieved(), 3U);
+    EXPECT_EQ(st.transactions, 2U + 1U + 3U);
+}
+
+TEST_F(TestMAX30102, AsyncRead)
+{
+    MockAsyncI2C bus(sim);
+    bus.setCallback([](const bool ok, void* arg) { static_cast<UnitMAX30102*>(arg)->completeAsyncRead(ok); },
+                    unit.get());
+
+    EXPECT_FALSE(unit->enableAsyncRead(MockAsyncI2C::start, &bus));  // In periodic
+    ASSERT_TRUE(unit->stopPeriodicMeasurement());
+    EXPECT_FALSE(unit->enableAsyncRead(nullptr));
+    ASSERT_TRUE(unit->enableAsyncRead(MockAsyncI2C::start, &bus));
+    EXPECT_TRUE(unit->inAsyncRead());
+    restart();
+
+    // update() returns after reading the pointers
+    sim.clearStatistics();
+    sim.advance(100 * 1000);
+    unit->update(true);
+    EXPECT_TRUE(unit->transferring());
+    EXPECT_FALSE(unit->updated());
+    EXPECT_EQ(unit->retrieved(), 0U);
+    EXPECT_TRUE(unit->empty());
+    EXPECT_EQ(sim.statistics().transactions, 2U);
+    EXPECT_FALSE(unit->stopPeriodicMeasurement());  // Transferring
+
+    // 50us + (3 + 60) bytes * 22.5us
+    bus.advance(1000);
+    unit->update(true);
+    EXPECT_FALSE(unit->updated());
+    EXPECT_FALSE(unit->poll());
+    bus.advance(1000);
+    EXPECT_TRUE(unit->poll());
+    EXPECT_TRUE(unit->updated());
+    EXPECT_FALSE(unit->transferring());
+    EXPECT_EQ(unit->retrieved(), 10U);
+    EXPECT_EQ(unit->available(), 10U);
+    EXPECT_EQ(unit->wireBytes(), sim.statistics().wire_bytes());
+    uint32_t idx = base;
+    for (auto&& d : unit->retrievedData()) {
+        EXPECT_EQ(d.ir(), expected(idx, 2));
+        EXPECT_EQ(d.red(), expected(idx, 1));
+        ++idx;
+    }
+
+    // Continuous, update() publishes after the completion (reads every 10ms)
+    unit->flush();
+    for (uint32_t ms = 0; ms < 1000; ++ms) {
+        sim.advance(1000);
+        bus.advance(1000);
+        unit->update(ms % 10 == 0);
+        if (unit->updated()) {
+            for (auto&& d : unit->retrievedData()) {
+                EXPECT_EQ(d.ir(), expected(idx, 2));
+                ++idx;
+            }
+        }
+    }
+    EXPECT_GE(idx, base + 100U);
+    EXPECT_EQ(sim.lost(), 0U);
+
+    // Failed transfer
+    while (unit->transferring()) {
+        bus.advance(1000);
+        unit->poll();
+    }
+    sim.advance(100 * 1000);
+    unit->update(true);
+    ASSERT_TRUE(unit->transferring());
+    sim.setFailure(true);
+    bus.advance(10 * 1000);
+    EXPECT_FALSE(unit->poll());
+    EXPECT_FALSE(unit->transferring());
+    sim.setFailure(false);
+
+    ASSERT_TRUE(unit->stopPeriodicMeasurement());
+    EXPECT_TRUE(unit->disableAsyncRead());
+    EXPECT_FALSE(unit->inAsyncRead());
+}
+
+TEST(MAX30102, AsyncReadOverlap)
+{
+    // Two units on the separate buses transfer at the same time
+    MAX30102Simulator sim[2]{};
+    std::unique_ptr<MockedUnit<UnitMAX30102>> unit[2]{};
+    std::unique_ptr<MockAsyncI2C> bus[2]{};
+    for (uint32_t i = 0; i < 2; ++i) {
+        sim[i].setGenerator(index_generator);
+        unit[i].reset(new MockedUnit<UnitMAX30102>(sim[i]));
+        bus[i].reset(new MockAsyncI2C(sim[i]));
+        bus[i]->setCallback([](const bool ok, void* arg) { static_cast<UnitMAX30102*>(arg)->completeAsyncRead(ok); },
+                            unit[i].get());
+        ASSERT_TRUE(unit[i]->begin());
+        ASSERT_TRUE(unit[i]->stopPeriodicMeasurement());
+        ASSERT_TRUE(unit[i]->enableAsyncRead(MockAsyncI2C::start, bus[i].get()));
+        ASSERT_TRUE(unit[i]->startPeriodicMeasurement());
+    }
+
+    uint32_t overlapped{}, published[2]{};
+    for (uint32_t ms = 0; ms < 1000; ++ms) {
+        for (uint32_t i = 0; i < 2; ++i) {
+            sim[i].advance(1000);
+            bus[i]->advance(1000);
+            unit[i]->update(ms % 10 == 0);
+            published[i] += unit[i]->updated() ? unit[i]->retrieved() : 0;
+        }
+        overlapped += bus[0]->busy() && bus[1]->busy();
+    }
+    EXPECT_GT(overlapped, 0U);
+    for (uint32_t i = 0; i < 2; ++i) {
+        EXPECT_GE(published[i], 90U);
+        EXPECT_EQ(sim[i].lost(), 0U);
+    }
+}
+
+TEST_F(TestMAX30102, AsyncReadCancel)
+{
+    MockAsyncI2C bus(sim);
+    bus.setCallback([](const bool ok, void* arg) { static_cast<UnitMAX30102*>(arg)->completeAsyncRead(ok); },
+                    unit.get());
+    struct Pin {
+        MAX30102Simulator* sim;
+        uint32_t calls;
+    } pin{&sim, 0};
+    auto counted_pin = [](void* arg) -> bool {
+        auto p = static_cast<Pin*>(arg);
+        ++p->calls;
+        return p->sim->interrupt();
+    };
+
+    ASSERT_TRUE(unit->stopPeriodicMeasurement());
+    ASSERT_TRUE(unit->enableAsyncRead(MockAsyncI2C::start, &bus));
+    ASSERT_TRUE(unit->enableInterruptMode(counted_pin, &pin, 4));
+    restart();
+    EXPECT_FALSE(unit->cancelAsyncRead());  // Not transferring
+
+    // The data ready function is not called while transferring
+    while (!sim.interrupt()) {
+        sim.advance(1000);
+    }
+    unit->update();
+    ASSERT_TRUE(unit->transferring());
+    const uint32_t calls = pin.calls;
+    for (uint32_t ms = 0; ms < 10; ++ms) {
+        sim.advance(1000);
+        unit->update();
+    }
+    EXPECT_EQ(pin.calls, calls);
+    EXPECT_TRUE(unit->transferring());
+
+    // Abandon the transfer that does not complete
+    bus.cancel();
+    EXPECT_TRUE(unit->cancelAsyncRead());
+    EXPECT_FALSE(unit->transferring());
+    EXPECT_EQ(sim.unread(), 0U);
+    unit->completeAsyncRead();  // Notified after the cancel
+    EXPECT_FALSE(unit->poll());
+    EXPECT_FALSE(unit->updated());
+
+    // The discarded samples are the gap of the next read
+    while (!sim.interrupt()) {
+        sim.advance(1000);
+    }
+    unit->update();
+    ASSERT_TRUE(unit->transferring());
+    bus.advance(10 * 1000);
+    EXPECT_TRUE(unit->poll());
+    EXPECT_EQ(unit->retrieved(), MAX_FIFO_DEPTH - 4);
+    EXPECT_EQ(unit->gap(), unit->sampleIndex());
+    EXPECT_EQ(unit->retrievedData()[0].ir(), expected(base + unit->sampleIndex(), 2));
+
+    ASSERT_TRUE(unit->stopPeriodicMeasurement());
+    EXPECT_TRUE(unit->disableInterruptMode());
+    EXPECT_TRUE(unit->disableAsyncRead());
+}
+
+TEST_F(TestMAX30102, Timeline)
+{
+    restart();
+    EXPECT_EQ(unit->samplePeriod(), 10000U);  // 100 sps
+
+    sim.advance(100 * 1000);
+    unit->update(true);
+    const uint32_t now = sim.now();
+    EXPECT_EQ(unit->retrieved(), 10U);
+    EXPECT_EQ(unit->gap(), 0U);
+    EXPECT_EQ(unit->sampleIndex(), 0U);
+    // The newest is at the read
+    EXPECT_EQ(unit->timestamp() + 9 * unit->samplePeriod(), now);
+
+    // Overflow, the lost samples are the gap before the batch
+    sim.advance(40 * 10 * 1000);
+    unit->update(true);
+    EXPECT_EQ(unit->retrieved(), 32U);
+    EXPECT_EQ(unit->overflow(), 8U);
+    EXPECT_EQ(unit->gap(), 8U);
+    EXPECT_EQ(unit->sampleIndex(), 10U + 8U);
+    EXPECT_EQ(unit->retrievedData()[0].ir(), expected(base + unit->sampleIndex(), 2));
+
+    // Continuous
+    sim.advance(50 * 1000);
+    unit->update(true);
+    EXPECT_EQ(unit->gap(), 0U);
+    EXPECT_EQ(unit->sampleIndex(), 10U + 8U + 32U);
+
+    // The overflow counter saturates
+    sim.advance(1000 * 1000);
+    unit->update(true);
+    EXPECT_EQ(unit->overflow(), 31U);
+    EXPECT_GE(unit->gap(), 31U);
+}
+
+TEST_F(TestMAX30102, InterruptMode)
+{
+    EXPECT_FALSE(unit->enableInterruptMode(int_pin, &sim));  // In periodic
+    ASSERT_TRUE(unit->stopPeriodicMeasurement());
+    EXPECT_FALSE(unit->enableInterruptMode(int_pin, &sim, 16));
+    ASSERT_TRUE(unit->enableInterruptMode(int_pin, &sim, 4));
+    EXPECT_TRUE(unit->inInterruptMode());
+
+    // The interrupt enable by the user is kept
+    constexpr uint8_t ALC_OVF{0x20};
+    ASSERT_TRUE(unit->writeRegister8(MAX30102Simulator::INT_ENABLE_1, ALC_OVF));
+
+    restart();
+    EXPECT_EQ(sim.peek(MAX30102Simulator::INT_ENABLE_1), static_cast<uint8_t>(MAX30102Simulator::INT_A_FULL | ALC_OVF));
+    EXPECT_EQ(sim.peek(MAX30102Simulator::FIFO_CONFIG) & 0x0FU, 4U);
+
+    // No bus access until the interrupt
+    sim.clearStatistics();
+    sim.advance(100 * 1000);
+    unit->update();
+    EXPECT_FALSE(unit->updated());
+    EXPECT_EQ(sim.statistics().transactions, 0U);
+
+    // One read drains a batch on each interrupt
+    uint32_t idx = base, batches{};
+    for (uint32_t ms = 0; ms < 10 * 1000; ++ms) {
+        sim.advance(1000);
+        unit->update();
+        if (unit->updated()) {
+            ++batches;
+            EXPECT_EQ(unit->retrieved(), MAX_FIFO_DEPTH - 4);
+            EXPECT_FALSE(sim.interrupt());
+            while (unit->available()) {
+                EXPECT_EQ(unit->ir(), expected(idx, 2));
+                unit->discard();
+                ++idx;
+            }
+        }
+    }
+    EXPECT_EQ(batches, (sim.generated() - base) / (MAX_FIFO_DEPTH - 4));
+    EXPECT_EQ(idx + sim.unread(), sim.generated());
+    EXPECT_EQ(sim.lost(), 0U);
+
+    ASSERT_TRUE(unit->stopPeriodicMeasurement());
+    ASSERT_TRUE(unit->disableInterruptMode());
+    EXPECT_EQ(sim.peek(MAX30102Simulator::INT_ENABLE_1), ALC_OVF);
+    restart();
+    EXPECT_EQ(sim.peek(MAX30102Simulator::INT_ENABLE_1), ALC_OVF);
+}
+
+TEST_F(TestMAX30102, InterruptNotify)
+{
+    ASSERT_TRUE(unit->stopPeriodicMeasurement());
+    ASSERT_TRUE(unit->enableInterruptMode(nullptr, nullptr, 0));
+    restart();
+
+    // Just full without overflow (the pointers are equal)
+    sim.advance(MAX_FIFO_DEPTH * 10 * 1000);
+    EXPECT_TRUE(sim.interrupt());
+    unit->update();
+    EXPECT_FALSE(unit->updated());  // Not notified
+
+    unit->notifyInterrupt();
+    unit->update();
+    EXPECT_TRUE(unit->updated());
+    EXPECT_EQ(unit->retrieved(), MAX_FIFO_DEPTH);
+    EXPECT_EQ(unit->overflow(), 0U);
+    EXPECT_FALSE(sim.interrupt());
+
+    uint8_t s1{}, s2{};
+    sim.advance(10 * 1000);
+    EXPECT_TRUE(unit->readInterruptStatus(s1, s2));
+    EXPECT_TRUE(s1 & MAX30102Simulator::INT_PPG_RDY);
+    EXPECT_TRUE(unit->readInterruptStatus(s1, s2));
+    EXPECT_EQ(s1, 0U);
+}
+
+TEST_F(TestMAX30102, AdaptivePolling)
+{
+    EXPECT_FALSE(unit->enableAdaptivePolling(0));
+    EXPECT_FALSE(unit->enableAdaptivePolling(MAX_FIFO_DEPTH));
+    ASSERT_TRUE(unit->enableAdaptivePolling());
+    EXPECT_TRUE(unit->inAdaptivePolling());
+    const uint8_t target = unit->adaptivePollingTarget();
+    EXPECT_EQ(target, MAX_FIFO_DEPTH * 3 / 4);
+
+    constexpr Sampling rate_table[] = {Sampling::Rate100, Sampling::Rate400, Sampling::Rate1000, Sampling::Rate3200};
+    for (auto&& rate : rate_table) {
+        SCOPED_TRACE(std::to_string(m5::stl::to_underlying(rate)));
+        restart(Mode::HROnly, rate);
+        const uint32_t lost = sim.lost();
+
+        // The caller polls as interval()
+        uint32_t polls{}, count{};
+        for (uint32_t ms = 0; ms < 10 * 1000; ms += unit->interval()) {
+            sim.advance(unit->interval() * 1000);
+            unit->update(true);
+            EXPECT_EQ(unit->overflow(), 0U);
+            if (ms >= 5 * 1000) {
+                count += unit->retrieved();
+                ++polls;
+            }
+            unit->flush();
+        }
+        EXPECT_EQ(sim.lost(), lost);
+        // Converged around the target
+        ASSERT_NE(polls, 0U);
+        EXPECT_GE(count / polls, target * 3U / 4U);
+        EXPECT_LE(count / polls, MAX_FIFO_DEPTH - 1U);
+
+        // Not narrowed by the loss of a late poll (the caller is the limit, not the interval)
+        const auto prev = unit->interval();
+        sim.advance(prev * 2 * 1000);
+        unit->update(true);
+        EXPECT_NE(unit->overflow(), 0U);
+        EXPECT_EQ(unit->interval(), prev);
+        unit->flush();
+    }
+
+    // The caller polls slower than interval(), the interval keeps the time to reach the target
+    ASSERT_TRUE(unit->stopPeriodicMeasurement());
+    ASSERT_TRUE(unit->enableAdaptivePolling(MAX_FIFO_DEPTH / 4));
+    restart(Mode::HROnly, Sampling::Rate100);
+    const uint32_t fill = MAX_FIFO_DEPTH / 4 * 10;  // ms at 100 sps
+    for (uint32_t i = 0; i < 20; ++i) {
+        sim.advance(fill * 3 * 1000);
+        unit->update(true);
+        EXPECT_EQ(unit->overflow(), 0U);
+        unit->flush();
+    }
+    EXPECT_GE(unit->interval(), fill * 3 / 4);
+    EXPECT_LE(unit->interval(), fill);
+
+    unit->disableAdaptivePolling();
+    EXPECT_FALSE(unit->inAdaptivePolling());
+    EXPECT_EQ(unit->interval(), 10U);  // 100 sps
+}
+
+TEST_F(TestMAX30102, RetrievedData)
+{
+    restart();
+    EXPECT_TRUE(unit->retrievedData().empty());
+
+    uint32_t idx = base;
+    for (uint32_t n = 1; n <= MAX_FIFO_DEPTH - 1; n += 7) {
+        sim.advance(n * 10 * 1000);
+        unit->update(true);
+        ASSERT_EQ(unit->retrieved(), n);
+
+        auto batch = unit->retrievedData();
+        ASSERT_EQ(batch.size(), n);
+        // Same as the stored data
+        EXPECT_EQ(unit->available(), n);
+        for (auto&& d : batch) {
+            EXPECT_EQ(d.ir(), expected(idx, 2));
+            EXPECT_EQ(d.red(), expected(idx, 1));
+            EXPECT_EQ(d.ir(), unit->ir());
+            unit->discard();
+            ++idx;
+        }
+    }
+
+    // Nothing new
+    unit->update(true);
+    EXPECT_TRUE(unit->retrievedData().empty());
+}
+
+TEST_F(TestMAX30102, DecodedStorage)
+{
+    auto cfg    = unit->config();
+    cfg.storage = Storage::Decoded;
+    unit->config(cfg);
+    ASSERT_TRUE(unit->begin());
+    EXPECT_TRUE(unit->decoded());
+    restart();
+
+    m5::heart::Span<const uint32_t> ir1{}, ir2{}, red1{}, red2{};
+    EXPECT_EQ(unit->decodedIR(ir1, ir2), 0U);
+    EXPECT_TRUE(unit->empty());
+
+    // Same values as Storage::Raw
+    uint32_t idx = base;
+    sim.advance(20 * 10 * 1000);
+    unit->update(true);
+    ASSERT_EQ(unit->retrieved(), 20U);
+    EXPECT_EQ(unit->available(), 20U);
+    EXPECT_EQ(unit->oldest().ir(), expected(idx, 2));
+    EXPECT_EQ(unit->latest().red(), expected(idx + 19, 1));
+    // Also through the adapter (generic code of UnitUnified)
+    auto& adapter = static_cast<PeriodicMeasurementAdapter<UnitMAX30102, Data>&>(*unit);
+    EXPECT_EQ(adapter.available(), 20U);
+    EXPECT_FALSE(adapter.empty());
+    EXPECT_EQ(adapter.oldest().ir(), expected(idx, 2));
+    EXPECT_EQ(adapter.latest().red(), expected(idx + 19, 1));
+    for (uint32_t i = 0; i < 5; ++i) {
+        EXPECT_EQ(unit->ir(), expected(idx, 2));
+        EXPECT_EQ(unit->red(), expected(idx, 1));
+        unit->discard();
+        ++idx;
+    }
+
+    // Wraps around and overwrites the oldest as the buffer of Data
+    sim.advance(25 * 10 * 1000);
+    unit->update(true);
+    ASSERT_EQ(unit->retrieved(), 25U);
+    EXPECT_TRUE(unit->full());
+    idx += 15 + 25 - MAX_FIFO_DEPTH;
+
+    EXPECT_EQ(unit->decodedIR(ir1, ir2), MAX_FIFO_DEPTH);
+    EXPECT_EQ(unit->decodedRed(red1, red2), MAX_FIFO_DEPTH);
+    EXPECT_FALSE(ir2.empty());
+    EXPECT_EQ(ir1.size() + ir2.size(), MAX_FIFO_DEPTH);
+    EXPECT_EQ(ir1.size(), red1.size());
+    uint32_t i{};
+    for (auto&& v : ir1) {
+        EXPECT_EQ(v, expected(idx + i, 2));
+        EXPECT_EQ(red1[i], expected(idx + i, 1));
+        ++i;
+    }
+    for (auto&& v : ir2) {
+        EXPECT_EQ(v, expected(idx + i, 2));
+        ++i;
+    }
+
+    // Bulk discard
+    unit->discard(ir1.size());
+    EXPECT_EQ(unit->available(), ir2.size());
+    EXPECT_EQ(unit->ir(), expected(idx + ir1.size(), 2));
+    unit->discard(MAX_FIFO_DEPTH * 2);
+    EXPECT_TRUE(unit->empty());
+    EXPECT_EQ(unit->ir(), 0U);
+    sim.advance(3 * 10 * 1000);
+    unit->update(true);
+    EXPECT_EQ(unit->available(), 3U);
+    adapter.discard();
+    EXPECT_EQ(adapter.available(), 2U);
+    adapter.flush();
+    EXPECT_TRUE(unit->empty());
+
+    // Back to Storage::Raw
+    cfg.storage = Storage::Raw;
+    unit->config(cfg);
+    ASSERT_TRUE(unit->begin());
+    EXPECT_FALSE(unit->decoded());
+    EXPECT_EQ(unit->decodedIR(ir1, ir2), 0U);
+    restart();
+    sim.advance(4 * 10 * 1000);
+    unit->update(true);
+    EXPECT_EQ(unit->available(), 4U);
+    unit->discard(3);
+    EXPECT_EQ(unit->available(), 1U);
+}
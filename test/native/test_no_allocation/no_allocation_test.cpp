@@ -0,0 +1,192 @@
+/*
+ * SPDX-FileCopyrightText: 2026 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for the allocation-free sample path after begin()
+  unit.update() -> read_FIFO() -> PulseMonitor::push_back() -> PulseMonitor::update()
+*/
+#include <gtest/gtest.h>
+#include <unit/unit_MAX30102.hpp>
+#include <unit/unit_MAX30100.hpp>
+#include <utility/pulse_monitor.hpp>
+#include "../mock_i2c.hpp"
+#include "../max30102_simulator.hpp"
+#include "../max30100_simulator.hpp"
+#include <cstdlib>
+#include <new>
+
+using namespace m5::unit;
+using namespace m5::heart;
+using namespace m5::heart::test;
+
+namespace {
+bool tracking{};
+uint32_t allocations{};
+
+void* allocate(const size_t sz)
+{
+    if (tracking) {
+        ++allocations;
+    }
+    return std::malloc(sz ? sz : 1);
+}
+
+// Not inlined into the replaced operators, or GCC warns of the malloc/free pair as mismatched with new/delete
+__attribute__((noinline)) void release(void* p)
+{
+    std::free(p);
+}
+
+struct Tracker {
+    Tracker()
+    {
+        allocations = 0;
+        tracking    = true;
+    }
+    ~Tracker()
+    {
+        tracking = false;
+    }
+};
+
+constexpr uint32_t stream_seconds{60 * 60};  // An hour
+constexpr uint32_t poll_ms{100};
+
+template <class U, class S>
+void stream(U& unit, S& sim, PulseMonitor& monitor, const uint32_t rate)
+{
+    uint32_t samples{}, failed{};
+    {
+        Tracker t;
+        for (uint32_t ms = 0; ms < stream_seconds * 1000; ms += poll_ms) {
+            sim.advance(poll_ms * 1000);
+            unit.update(true);
+            failed += !unit.updated();
+            while (unit.available()) {
+                monitor.push_back(unit.ir(), unit.red());
+                unit.discard();
+                ++samples;
+            }
+            monitor.update();
+        }
+    }
+    EXPECT_EQ(allocations, 0U);
+
+    // The stream must have actually gone through the path
+    EXPECT_EQ(failed, 0U);
+    EXPECT_EQ(samples, sim.generated());
+    EXPECT_EQ(samples, rate * stream_seconds);
+    EXPECT_EQ(sim.lost(), 0U);
+    EXPECT_NEAR(monitor.bpm(), 72.f, 72.f * 0.05f);
+}
+}  // namespace
+
+// Hooks for the whole test binary
+void* operator new(size_t sz)
+{
+    void* p = allocate(sz);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+void* operator new[](size_t sz)
+{
+    return operator new(sz);
+}
+void* operator new(size_t sz, const std::nothrow_t&) noexcept
+{
+    return allocate(sz);
+}
+void* operator new[](size_t sz, const std::nothrow_t&) noexcept
+{
+    return allocate(sz);
+}
+void operator delete(void* p) noexcept
+{
+    release(p);
+}
+void operator delete[](void* p) noexcept
+{
+    release(p);
+}
+void operator delete(void* p, size_t) noexcept
+{
+    release(p);
+}
+void operator delete[](void* p, size_t) noexcept
+{
+    release(p);
+}
+
+TEST(NoAllocation, Hook)
+{
+    {
+        Tracker t;
+        auto p = new int{};
+        asm volatile("" : : "r"(p) : "memory");  // Not to be elided
+        delete p;
+    }
+    EXPECT_EQ(allocations, 1U);
+}
+
+TEST(NoAllocation, MAX30102)
+{
+    MAX30102Simulator sim{};
+    MockedUnit<UnitMAX30102> unit(sim);
+
+    auto cfg = unit.config();
+    cfg.mode = max30102::Mode::SpO2;
+    unit.config(cfg);
+    ASSERT_TRUE(unit.begin());
+    ASSERT_TRUE(unit.inPeriodic());
+
+    const uint32_t rate = unit.calculateSamplingRate();
+    ASSERT_EQ(rate, sim.samplingRate());
+    PulseMonitor monitor(rate, 5);
+    stream(unit, sim, monitor, rate);
+}
+
+TEST(NoAllocation, MAX30100)
+{
+    MAX30100Simulator sim{};
+    MockedUnit<UnitMAX30100> unit(sim);
+
+    ASSERT_TRUE(unit.begin());
+    ASSERT_TRUE(unit.inPeriodic());
+
+    const uint32_t rate = unit.calculateSamplingRate();
+    ASSERT_EQ(rate, sim.samplingRate());
+    PulseMonitor monitor(rate, 5);
+    stream(unit, sim, monitor, rate);
+}
+
+TEST(NoAllocation, OptionalCalculations)
+{
+    // The optional calculations allocate only when enabled, not on the stream
+    using enable_function_t = bool (*)(PulseMonitor& monitor, const uint32_t rate);
+    const enable_function_t enables[] = {
+        [](PulseMonitor& monitor, const uint32_t rate) { return monitor.enableSlidingSpO2(rate * 2, rate / 4); },
+        [](PulseMonitor& monitor, const uint32_t) { return monitor.enableBeatSpO2(4); },
+        [](PulseMonitor& monitor, const uint32_t) { return monitor.enableGoertzelBPM(); },
+        [](PulseMonitor& monitor, const uint32_t) { return monitor.enableAutocorrelationBPM(); },
+    };
+    for (size_t i = 0; i < sizeof(enables) / sizeof(enables[0]); ++i) {
+        SCOPED_TRACE(i);
+        MAX30102Simulator sim{};
+        MockedUnit<UnitMAX30102> unit(sim);
+
+        auto cfg = unit.config();
+        cfg.mode = max30102::Mode::SpO2;
+        unit.config(cfg);
+        ASSERT_TRUE(unit.begin());
+        ASSERT_TRUE(unit.inPeriodic());
+
+        const uint32_t rate = unit.calculateSamplingRate();
+        PulseMonitor monitor(rate, 5);
+        ASSERT_TRUE(enables[i](monitor, rate));
+        stream(unit, sim, monitor, rate);
+    }
+}
@@ -0,0 +1,968 @@
+/*
+ * SPDX-FileCopyrightText: 2026 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for PulseMonitor
+*/
+#include <gtest/gtest.h>
+#include <utility/pulse_monitor.hpp>
+#include <utility/fixed_pulse_monitor.hpp>
+#include <utility/pulse_monitor_bank.hpp>
+#include <utility/span.hpp>
+#include "../synthetic_ppg.hpp"
+#include "../legacy_pulse_monitor.hpp"
+#include <string>
+#include <vector>
+
+// PulseMonitor is a class, so the user code can forward-declare it
+namespace m5 {
+namespace heart {
+class PulseMonitor;
+}  // namespace heart
+}  // namespace m5
+
+using namespace m5::heart;
+using namespace m5::heart::test;
+
+namespace {
+
+struct Condition {
+    uint32_t rate, sec;
+    float bpm;
+    uint32_t seed;
+};
+
+constexpr Condition conditions[] = {
+    {50, 1, 60.f, 1},   {50, 5, 110.f, 2},  {100, 2, 72.f, 3},  {100, 5, 48.f, 4},
+    {100, 10, 90.f, 5}, {200, 3, 150.f, 6}, {400, 5, 72.f, 7},  {400, 1, 180.f, 8},
+    {800, 2, 65.f, 9},  {167, 4, 85.f, 10}, {1000, 5, 60.f, 11},
+};
+
+}  // namespace
+
+TEST(PulseMonitor, BeatDetectorMatchesWindowScan)
+{
+    for (auto&& c : conditions) {
+        SCOPED_TRACE(std::to_string(c.rate) + "sps " + std::to_string(c.sec) + "sec " + std::to_string(c.bpm));
+
+        PPGParams params{};
+        params.bpm  = c.bpm;
+        params.seed = c.seed;
+        auto trace  = make_ppg(c.rate, 30.f, params);
+
+        PulseMonitor monitor(c.rate, c.sec);
+        LegacyMonitor reference(c.rate, c.sec);
+
+        uint32_t beats{}, mismatch{};
+        for (auto&& s : trace) {
+            monitor.push_back(s.ir, s.red);
+            monitor.update();
+            reference.push_back(s.ir);
+            reference.update();
+
+            EXPECT_EQ(monitor.isBeat(), reference._beat);
+            EXPECT_NEAR(monitor.bpm(), reference._bpm, reference._bpm * 1e-4f);
+            mismatch += (monitor.isBeat() != reference._beat);
+            beats += reference._beat;
+            if (mismatch > 8) {
+                FAIL() << "Too many mismatches";
+            }
+        }
+        // The trace must actually contain beats for the comparison to mean anything
+        EXPECT_GT(beats, 0U);
+    }
+}
+
+TEST(PulseMonitor, BatchedUpdate)
+{
+    // update() may be called once per FIFO batch; the result must still match the window scan
+    constexpr uint32_t rate{400};
+    auto trace = make_ppg(rate, 20.f);
+
+    PulseMonitor monitor(rate, 5);
+    LegacyMonitor reference(rate, 5);
+
+    uint32_t n{};
+    for (auto&& s : trace) {
+        monitor.push_back(s.ir, s.red);
+        reference.push_back(s.ir);
+        if (++n % 13 == 0) {
+            monitor.update();
+            reference.update();
+            EXPECT_EQ(monitor.isBeat(), reference._beat);
+            EXPECT_NEAR(monitor.bpm(), reference._bpm, reference._bpm * 1e-4f);
+        }
+    }
+    EXPECT_NEAR(monitor.bpm(), 72.f, 72.f * 0.05f);
+}
+
+TEST(PulseMonitor, RRIntervals)
+{
+    constexpr uint32_t rate{100};
+    PPGParams params{};
+    params.bpm         = 60.f;
+    params.variability = 0.0f;
+    auto trace         = make_ppg(rate, 12.f, params);
+
+    BeatDetector detector(rate * 5);
+    Filter filter(5.0f, rate);
+    for (auto&& s : trace) {
+        detector.push_back(filter.process(s.ir));
+    }
+    ASSERT_GE(detector.intervals(), 3U);
+    EXPECT_EQ(detector.intervals() + 1, detector.peaks());
+    uint32_t sum{};
+    for (size_t i = 0; i < detector.intervals(); ++i) {
+        EXPECT_NEAR(detector.interval(i), rate, rate * 0.08f);  // Jitter by noise
+        sum += detector.interval(i);
+    }
+    EXPECT_FLOAT_EQ(detector.averageRR(), static_cast<float>(sum) / detector.intervals());
+    EXPECT_NEAR(detector.bpm(rate), 60.f, 1.0f);
+}
+
+TEST(PulseMonitor, SetSamplingRateAndClear)
+{
+    PulseMonitor monitor(100, 2);
+    auto trace = make_ppg(100, 10.f);
+    for (auto&& s : trace) {
+        monitor.push_back(s.ir, s.red);
+        monitor.update();
+    }
+    EXPECT_GT(monitor.bpm(), 0.0f);
+
+    monitor.clear();
+    EXPECT_EQ(monitor.bpm(), 0.0f);
+    EXPECT_FALSE(monitor.isBeat());
+    EXPECT_TRUE(std::isnan(monitor.latestIR()));
+
+    // The filter restarts too, the same as the new one
+    BiquadPulseMonitor biquad(100, 2);
+    for (auto&& s : trace) {
+        biquad.push_back(s.ir, s.red);
+    }
+    biquad.clear();
+    PulseMonitor fresh(100, 2);
+    BiquadPulseMonitor biquad_fresh(100, 2);
+    for (size_t i = 0; i < 100; ++i) {
+        monitor.push_back(trace[i].ir, trace[i].red);
+        fresh.push_back(trace[i].ir, trace[i].red);
+        biquad.push_back(trace[i].ir, trace[i].red);
+        biquad_fresh.push_back(trace[i].ir, trace[i].red);
+        EXPECT_FLOAT_EQ(monitor.latestIR(), fresh.latestIR());
+        EXPECT_FLOAT_EQ(biquad.latestIR(), biquad_fresh.latestIR());
+    }
+
+    monitor.setSamplingRate(200);
+    LegacyMonitor reference(200, 2);
+    trace = make_ppg(200, 10.f);
+    for (auto&& s : trace) {
+        monitor.push_back(s.ir, s.red);
+        monitor.update();
+        reference.push_back(s.ir);
+        reference.update();
+        EXPECT_EQ(monitor.isBeat(), reference._beat);
+        EXPECT_NEAR(monitor.bpm(), reference._bpm, reference._bpm * 1e-4f);
+    }
+}
+
+namespace {
+// Same interface as the Data of the units
+struct Sample {
+    uint32_t _ir, _red;
+    inline uint32_t ir() const
+    {
+        return _ir;
+    }
+    inline uint32_t red() const
+    {
+        return _red;
+    }
+};
+}  // namespace
+
+TEST(PulseMonitor, PushBackRange)
+{
+    constexpr uint32_t rate{100};
+    auto trace = make_ppg(rate, 20.f);
+    std::vector<Sample> samples{};
+    std::vector<float> irs{};
+    for (auto&& s : trace) {
+        samples.push_back(Sample{s.ir, s.red});
+        irs.push_back(static_cast<float>(s.ir));
+    }
+
+    PulseMonitor each(rate, 5), bulk(rate, 5), bulk_ir(rate, 5), each_ir(rate, 5);
+    constexpr size_t batch{13};
+    for (size_t i = 0; i < samples.size(); i += batch) {
+        const size_t n = std::min(batch, samples.size() - i);
+        for (size_t j = i; j < i + n; ++j) {
+            each.push_back(trace[j].ir, trace[j].red);
+            each_ir.push_back(trace[j].ir);
+        }
+        bulk.push_back(Span<const Sample>(samples.data() + i, n));
+        bulk_ir.push_back(Span<const float>(irs.data() + i, n));
+        each.update();
+        bulk.update();
+        each_ir.update();
+        bulk_ir.update();
+
+        EXPECT_EQ(bulk.isBeat(), each.isBeat());
+        EXPECT_FLOAT_EQ(bulk.bpm(), each.bpm());
+        EXPECT_FLOAT_EQ(bulk.SpO2(), each.SpO2());
+        EXPECT_FLOAT_EQ(bulk.latestIR(), each.latestIR());
+        EXPECT_FLOAT_EQ(bulk_ir.bpm(), each_ir.bpm());
+    }
+    EXPECT_GT(bulk.SpO2(), 0.0f);
+    EXPECT_NEAR(bulk.bpm(), 72.f, 72.f * 0.05f);
+
+    // Arithmetic values still go to push_back(ir)
+    PulseMonitor a(rate, 5), b(rate, 5);
+    a.push_back(50000);
+    b.push_back(50000.0f);
+    EXPECT_FLOAT_EQ(a.latestIR(), b.latestIR());
+    // Containers too
+    a.push_back(irs);
+    b.push_back(Span<const float>(irs.data(), irs.size()));
+    a.update();
+    b.update();
+    EXPECT_FLOAT_EQ(a.bpm(), b.bpm());
+}
+
+namespace {
+// Same as the runtime settings
+template <class M>
+void check_compile_time(M& fixed, const uint32_t rate, const uint32_t sec, const float bpm)
+{
+    SCOPED_TRACE(std::to_string(rate) + "sps " + std::to_string(sec) + "sec");
+    PPGParams params{};
+    params.bpm = bpm;
+    auto trace = make_ppg(rate, 20.f, params);
+    PulseMonitor monitor(rate, sec);
+    for (auto&& s : trace) {
+        monitor.push_back(s.ir, s.red);
+        monitor.update();
+        fixed.push_back(s.ir, s.red);
+        fixed.update();
+        EXPECT_EQ(fixed.isBeat(), monitor.isBeat());
+        EXPECT_FLOAT_EQ(fixed.bpm(), monitor.bpm());
+        EXPECT_FLOAT_EQ(fixed.SpO2(), monitor.SpO2());
+        EXPECT_FLOAT_EQ(fixed.latestIR(), monitor.latestIR());
+    }
+    EXPECT_NEAR(fixed.bpm(), bpm, bpm * 0.05f);
+
+    fixed.clear();
+    EXPECT_EQ(fixed.bpm(), 0.0f);
+    EXPECT_TRUE(std::isnan(fixed.latestIR()));
+}
+}  // namespace
+
+TEST(PulseMonitor, CompileTimeSettings)
+{
+    static_assert(PulseMonitorT<100, 2>::samplingRate() == 100, "Compile time");
+    static_assert(PulseMonitorT<100, 2>::filter_coefficient > 0.0f, "Compile time");
+
+    PulseMonitorT<100, 2> m100{};
+    check_compile_time(m100, 100, 2, 72.f);
+    PulseMonitorT<400, 5> m400{};
+    check_compile_time(m400, 400, 5, 120.f);
+    PulseMonitorT<50, 1> m50{};
+    check_compile_time(m50, 50, 1, 150.f);
+}
+
+TEST(PulseMonitor, Process)
+{
+    constexpr uint32_t rate{400};
+    auto trace = make_ppg(rate, 20.f);
+    std::vector<float> irs{}, reds{};
+    for (auto&& s : trace) {
+        irs.push_back(s.ir);
+        reds.push_back(s.red);
+    }
+
+    PulseMonitor each(rate, 5), block(rate, 5), block_ir(rate, 5);
+    PulseMonitorT<rate, 5> block_t{};
+    constexpr size_t batch{32};  // FIFO depth of MAX30102
+    bool beats[batch]{}, beats_ir[batch]{};
+    uint32_t total{};
+    for (size_t i = 0; i < irs.size(); i += batch) {
+        const size_t n = std::min(batch, irs.size() - i);
+        size_t expected{};
+        for (size_t j = 0; j < n; ++j) {
+            each.push_back(irs[i + j], reds[i + j]);
+            each.update();
+            beats[j] = each.isBeat();
+            expected += beats[j];
+        }
+        bool got[batch]{};
+        EXPECT_EQ(block.process(irs.data() + i, reds.data() + i, n, got), expected);
+        EXPECT_EQ(block_ir.process(irs.data() + i, nullptr, n, beats_ir), expected);
+        EXPECT_EQ(block_t.process(irs.data() + i, reds.data() + i, n), expected);
+        for (size_t j = 0; j < n; ++j) {
+            EXPECT_EQ(got[j], beats[j]);
+            EXPECT_EQ(beats_ir[j], beats[j]);
+        }
+        EXPECT_EQ(block.isBeat(), each.isBeat());
+        EXPECT_FLOAT_EQ(block.bpm(), each.bpm());
+        EXPECT_FLOAT_EQ(block.SpO2(), each.SpO2());
+        EXPECT_FLOAT_EQ(block.latestIR(), each.latestIR());
+        EXPECT_FLOAT_EQ(block_ir.bpm(), each.bpm());
+        EXPECT_FLOAT_EQ(block_t.bpm(), each.bpm());
+        total += expected;
+    }
+    EXPECT_GT(total, 0U);
+    EXPECT_EQ(block_ir.SpO2(), 0.0f);
+}
+
+TEST(PulseMonitor, LazyBPM)
+{
+    constexpr uint32_t rate{100};
+    auto trace = make_ppg(rate, 20.f);
+
+    PulseMonitor lazy(rate, 5);
+    LegacyMonitor reference(rate, 5);
+    uint32_t n{};
+    float prev{};
+    for (auto&& s : trace) {
+        lazy.push_back(s.ir, s.red);
+        reference.push_back(s.ir);
+        // bpm() keeps the value of the latest update() until the next one
+        EXPECT_EQ(lazy.bpm(), prev);
+        lazy.update();
+        reference.update();
+        lazy.update();  // Nothing new
+        EXPECT_EQ(lazy.isBeat(), reference._beat);
+        // Read only once per second
+        if (++n % rate == 0) {
+            EXPECT_NEAR(lazy.bpm(), reference._bpm, reference._bpm * 1e-4f);
+            EXPECT_EQ(lazy.bpm(), lazy.bpm());
+        }
+        prev = lazy.bpm();
+    }
+    EXPECT_NEAR(lazy.bpm(), 72.f, 72.f * 0.05f);
+
+    lazy.clear();
+    lazy.update();
+    EXPECT_EQ(lazy.bpm(), 0.0f);
+    EXPECT_FALSE(lazy.isBeat());
+}
+
+TEST(PulseMonitor, SlidingSpO2)
+{
+    constexpr uint32_t rate{100};
+    auto trace = make_ppg(rate, 20.f);
+
+    PulseMonitor block(rate, 5), sliding(rate, 5), fast(rate, 5), beat(rate, 5);
+    EXPECT_FALSE(block.inSlidingSpO2());
+    EXPECT_FALSE(sliding.enableSlidingSpO2(0, rate));
+    EXPECT_FALSE(sliding.inSlidingSpO2());
+    // Same window and cadence as the 1 sec block
+    EXPECT_TRUE(sliding.enableSlidingSpO2(rate, rate));
+    EXPECT_TRUE(sliding.inSlidingSpO2());
+    // 4 sec window updated every 0.1 sec, and at each beat
+    EXPECT_TRUE(fast.enableSlidingSpO2(rate * 4, rate / 10));
+    EXPECT_TRUE(beat.enableSlidingSpO2(rate * 4, 0));
+
+    uint32_t changed_block{}, changed_fast{}, changed_beat{}, beats{};
+    for (auto&& s : trace) {
+        const float pb = block.SpO2(), pf = fast.SpO2(), pbt = beat.SpO2();
+        block.push_back(s.ir, s.red);
+        sliding.push_back(s.ir, s.red);
+        fast.push_back(s.ir, s.red);
+        beat.push_back(s.ir, s.red);
+        EXPECT_NEAR(sliding.SpO2(), block.SpO2(), 1e-3f);
+        changed_block += (pb != block.SpO2());
+        changed_fast += (pf != fast.SpO2());
+        changed_beat += (pbt != beat.SpO2());
+        beat.update();
+        beats += beat.isBeat();
+        // Updated only at the beats
+        if (pbt != beat.SpO2()) {
+            EXPECT_TRUE(beat.isBeat());
+        }
+    }
+    EXPECT_GT(changed_fast, changed_block * 5);
+    EXPECT_GT(changed_beat, 0U);
+    EXPECT_LE(changed_beat, beats);
+    EXPECT_GE(fast.SpO2(), 80.f);
+    EXPECT_LE(fast.SpO2(), 100.f);
+    EXPECT_NEAR(fast.SpO2(), beat.SpO2(), 2.0f);
+
+    fast.clear();
+    EXPECT_TRUE(fast.inSlidingSpO2());
+    EXPECT_EQ(fast.SpO2(), 0.0f);
+    fast.disableSlidingSpO2();
+    EXPECT_FALSE(fast.inSlidingSpO2());
+}
+
+TEST(PulseMonitor, BeatSpO2)
+{
+    constexpr uint32_t rate{100};
+    PPGParams params{};
+    params.bpm = 45.f;  // Low heart rate, 1 sec blocks are not aligned to the cycles
+    auto trace = make_ppg(rate, 40.f, params);
+
+    PulseMonitor block(rate, 5), beat(rate, 5);
+    EXPECT_FALSE(beat.enableBeatSpO2(0));
+    EXPECT_FALSE(beat.inBeatSpO2());
+    EXPECT_TRUE(beat.enableBeatSpO2(4));
+    EXPECT_TRUE(beat.inBeatSpO2());
+    // Exclusive with the sliding window
+    EXPECT_TRUE(beat.enableSlidingSpO2(rate, rate));
+    EXPECT_FALSE(beat.inBeatSpO2());
+    EXPECT_TRUE(beat.enableBeatSpO2(4));
+    EXPECT_FALSE(beat.inSlidingSpO2());
+
+    std::vector<float> vb, vs;
+    uint32_t n{};
+    for (auto&& s : trace) {
+        const float prev = beat.SpO2();
+        block.push_back(s.ir, s.red);
+        beat.push_back(s.ir, s.red);
+        beat.update();
+        // Updated only at the beats
+        if (prev != beat.SpO2()) {
+            EXPECT_TRUE(beat.isBeat());
+        }
+        // After settled
+        if (++n > rate * 10 && n % (rate / 4) == 0) {
+            vb.push_back(block.SpO2());
+            vs.push_back(beat.SpO2());
+        }
+    }
+    auto stddev = [](const std::vector<float>& v) {
+        float mean{}, sq{};
+        for (auto&& e : v) {
+            mean += e;
+        }
+        mean /= v.size();
+        for (auto&& e : v) {
+            sq += (e - mean) * (e - mean);
+        }
+        return std::sqrt(sq / v.size());
+    };
+    EXPECT_LT(stddev(vs), stddev(vb) * 0.5f);
+    EXPECT_GE(beat.SpO2(), 80.f);
+    EXPECT_LE(beat.SpO2(), 100.f);
+
+    beat.clear();
+    EXPECT_TRUE(beat.inBeatSpO2());
+    EXPECT_EQ(beat.SpO2(), 0.0f);
+    beat.disableBeatSpO2();
+    EXPECT_FALSE(beat.inBeatSpO2());
+}
+
+TEST(PulseMonitor, Bank)
+{
+    constexpr uint32_t rate{200};
+    constexpr size_t N{5};
+    // Different heart rates and levels on each channel
+    std::vector<std::vector<PPGSample>> traces{};
+    std::vector<std::unique_ptr<PulseMonitor>> monitors{};
+    for (size_t ch = 0; ch < N; ++ch) {
+        PPGParams params{};
+        params.bpm   = 50.f + 25.f * ch;
+        params.ir_dc = 30000.f + 10000.f * ch;
+        params.seed  = static_cast<uint32_t>(ch + 1);
+        traces.push_back(make_ppg(rate, 15.f, params));
+        monitors.emplace_back(new PulseMonitor(rate, 3));
+    }
+
+    PulseMonitorBank<N> bank(rate, 3);
+    EXPECT_EQ(bank.channels(), N);
+    EXPECT_TRUE(std::isnan(bank.latestIR(0)));
+    size_t beats{};
+    for (size_t i = 0; i < traces[0].size(); ++i) {
+        float ir[N]{}, red[N]{};
+        for (size_t ch = 0; ch < N; ++ch) {
+            ir[ch]  = traces[ch][i].ir;
+            red[ch] = traces[ch][i].red;
+            monitors[ch]->push_back(ir[ch], red[ch]);
+            monitors[ch]->update();
+        }
+        bank.push_back(ir, red);
+        bank.update();
+        for (size_t ch = 0; ch < N; ++ch) {
+            EXPECT_EQ(bank.isBeat(ch), monitors[ch]->isBeat());
+            EXPECT_FLOAT_EQ(bank.bpm(ch), monitors[ch]->bpm());
+            EXPECT_FLOAT_EQ(bank.SpO2(ch), monitors[ch]->SpO2());
+            EXPECT_FLOAT_EQ(bank.latestIR(ch), monitors[ch]->latestIR());
+            beats += bank.isBeat(ch);
+        }
+    }
+    for (size_t ch = 0; ch < N; ++ch) {
+        EXPECT_NEAR(bank.bpm(ch), 50.f + 25.f * ch, (50.f + 25.f * ch) * 0.05f);
+    }
+
+    // Gap and process() of all channels, same as PulseMonitor
+    PulseMonitorBank<N> marked(rate, 3), block(rate, 3);
+    std::vector<std::unique_ptr<PulseMonitor>> references{};
+    for (size_t ch = 0; ch < N; ++ch) {
+        references.emplace_back(new PulseMonitor(rate, 3));
+    }
+    std::vector<float> irs, reds;  // [samples][N]
+    for (size_t i = 0; i < traces[0].size(); ++i) {
+        float ir[N]{}, red[N]{};
+        for (size_t ch = 0; ch < N; ++ch) {
+            ir[ch]  = traces[ch][i].ir;
+            red[ch] = traces[ch][i].red;
+            irs.push_back(ir[ch]);
+            reds.push_back(red[ch]);
+        }
+        // Drop 15 samples every 1.5 sec
+        if (i % 300 >= 285) {
+            if (i % 300 == 285) {
+                marked.markGap(15);
+                for (auto&& m : references) {
+                    m->markGap(15);
+                }
+            }
+            continue;
+        }
+        marked.push_back(ir, red);
+        for (size_t ch = 0; ch < N; ++ch) {
+            references[ch]->push_back(ir[ch], red[ch]);
+        }
+    }
+    marked.update();
+    EXPECT_EQ(block.process(irs.data(), reds.data(), traces[0].size()), beats);
+    for (size_t ch = 0; ch < N; ++ch) {
+        references[ch]->update();
+        EXPECT_FLOAT_EQ(marked.bpm(ch), references[ch]->bpm());
+        EXPECT_FLOAT_EQ(marked.SpO2(ch), references[ch]->SpO2());
+        EXPECT_FLOAT_EQ(marked.latestIR(ch), references[ch]->latestIR());
+        EXPECT_FLOAT_EQ(block.bpm(ch), bank.bpm(ch));
+        EXPECT_FLOAT_EQ(block.SpO2(ch), bank.SpO2(ch));
+        EXPECT_FLOAT_EQ(block.latestIR(ch), bank.latestIR(ch));
+    }
+    marked.markGap(rate);
+    EXPECT_EQ(marked.bpm(0), 0.0f);
+    EXPECT_TRUE(std::isnan(marked.latestIR(0)));
+
+    bank.clear();
+    EXPECT_EQ(bank.bpm(0), 0.0f);
+    EXPECT_TRUE(std::isnan(bank.latestIR(0)));
+    bank.setSamplingRate(100);
+    EXPECT_EQ(bank.samplingRate(), 100U);
+}
+
+namespace {
+// Steady-state gain at the frequency
+template <class F>
+float gain(F& f, const float freq, const float rate)
+{
+    constexpr float pi{3.14159265358979323846f};
+    const uint32_t n = static_cast<uint32_t>(rate * 20);
+    float peak{};
+    for (uint32_t i = 0; i < n; ++i) {
+        const float y = f.process(std::sin(2.0f * pi * freq * i / rate));
+        if (i > n / 2) {
+            peak = std::max(peak, std::fabs(y));
+        }
+    }
+    return peak;
+}
+}  // namespace
+
+TEST(Biquad, Response)
+{
+    constexpr float rate{400.f};
+    {
+        BiquadCascade<3> bp;
+        bp.set(0, Biquad::highpass(0.5f, rate));
+        bp.set(1, Biquad::lowpass(5.0f, rate));
+        bp.set(2, Biquad::notch(50.f, rate));
+        EXPECT_NEAR(gain(bp, 1.5f, rate), 1.0f, 0.1f);
+        bp.reset();
+        EXPECT_LT(gain(bp, 0.05f, rate), 0.05f);
+        bp.reset();
+        EXPECT_LT(gain(bp, 50.f, rate), 0.01f);
+        bp.reset();
+        EXPECT_LT(gain(bp, 30.f, rate), 0.05f);
+    }
+    {
+        Biquad b;
+        b.set(Biquad::bandpass(2.0f, rate, 1.0f));
+        EXPECT_NEAR(gain(b, 2.0f, rate), 1.0f, 0.02f);
+        // Notch above the Nyquist is pass-through
+        b.set(Biquad::notch(60.f, 100.f));
+        EXPECT_FLOAT_EQ(b.process(123.f), 123.f);
+    }
+    {
+        // Primed by the DC, no step response
+        Biquad b;
+        b.set(Biquad::highpass(0.5f, rate));
+        EXPECT_NEAR(b.prime(50000.f), 0.0f, 1e-2f);
+        EXPECT_NEAR(b.process(50000.f), 0.0f, 1e-2f);
+    }
+    {
+        // The DC offset latched by BiquadFilter is the same as priming the cascade
+        BiquadFilter filter{};
+        filter.setSamplingRate(rate);
+        BiquadCascade<3> bp;
+        bp.set(0, Biquad::highpass(0.5f, rate));
+        bp.set(1, Biquad::lowpass(5.0f, rate));
+        bp.set(2, Biquad::notch(50.f, rate));
+        auto trace = make_ppg(static_cast<uint32_t>(rate), 5.f);
+        EXPECT_NEAR(filter.process(trace[0].ir), -bp.prime(trace[0].ir), 1e-2f);
+        // Float rounding differs, since the cascade filters the DC of the raw samples
+        float diff{}, peak{};
+        for (size_t i = 1; i < trace.size(); ++i) {
+            const float y = filter.process(trace[i].ir);
+            diff          = std::max(diff, std::fabs(y + bp.process(trace[i].ir)));
+            peak          = std::max(peak, std::fabs(y));
+        }
+        EXPECT_LT(diff, peak * 0.01f);
+
+        // clear() latches the next sample again
+        filter.clear();
+        EXPECT_NEAR(filter.process(trace[0].ir + 1000.f), 0.0f, 1e-2f);
+    }
+}
+
+TEST(PulseMonitor, BiquadPolicy)
+{
+    for (uint32_t rate : {100U, 200U, 400U}) {
+        SCOPED_TRACE(rate);
+        PPGParams params{};
+        params.bpm   = 66.f;
+        params.noise = 30.f;
+        auto trace   = make_ppg(rate, 20.f, params);
+
+        BiquadPulseMonitor mon(rate, 5);
+        PulseMonitor def(rate, 5);
+        for (auto&& s : trace) {
+            mon.push_back(s.ir, s.red);
+            def.push_back(s.ir, s.red);
+        }
+        mon.update();
+        def.update();
+        EXPECT_NEAR(mon.bpm(), 66.f, 66.f * 0.05f);
+        EXPECT_NEAR(mon.SpO2(), def.SpO2(), 1e-3f);
+
+        // Reconfigured for the sampling rate
+        mon.setSamplingRate(rate * 2);
+        EXPECT_EQ(mon.samplingRate(), rate * 2);
+        EXPECT_TRUE(std::isnan(mon.latestIR()));
+    }
+}
+
+TEST(PulseMonitor, GoertzelBPM)
+{
+    struct Case {
+        uint32_t rate;
+        float bpm;
+        float ir_ac;
+    };
+    // Normal and low perfusion
+    const Case cases[] = {{100, 72.f, 1500.f}, {100, 48.f, 1500.f}, {200, 150.f, 1500.f},
+                          {400, 96.f, 1500.f}, {100, 72.f, 60.f},   {400, 110.f, 60.f}};
+    for (auto&& c : cases) {
+        SCOPED_TRACE(std::to_string(c.rate) + "sps " + std::to_string(c.bpm) + "bpm " + std::to_string(c.ir_ac));
+        PPGParams params{};
+        params.bpm   = c.bpm;
+        params.ir_ac = c.ir_ac;
+        auto trace   = make_ppg(c.rate, 20.f, params);
+
+        PulseMonitor peak(c.rate, 8), spectral(c.rate, 8);
+        EXPECT_FALSE(spectral.enableGoertzelBPM(0.0f));
+        EXPECT_TRUE(spectral.enableGoertzelBPM(4.0f));
+        EXPECT_TRUE(spectral.inGoertzelBPM());
+        uint32_t n{}, changed{};
+        float prev{};
+        for (auto&& s : trace) {
+            peak.push_back(s.ir, s.red);
+            spectral.push_back(s.ir, s.red);
+            peak.update();
+            spectral.update();
+            changed += (prev != spectral.bpm());
+            prev = spectral.bpm();
+            // Not before the window is filled
+            if (++n < c.rate * 8) {
+                EXPECT_EQ(spectral.bpm(), 0.0f);
+            }
+        }
+        // Refreshed at 4 Hz
+        EXPECT_GE(changed, 1U);
+        EXPECT_LE(changed, 12U * 4 + 1);
+        EXPECT_NEAR(spectral.bpm(), c.bpm, c.bpm * 0.03f);
+        // Peak counting misses the beats under the threshold
+        if (c.ir_ac < 100.f) {
+            EXPECT_GT(std::fabs(peak.bpm() - c.bpm), c.bpm * 0.03f);
+        }
+    }
+
+    PulseMonitor mon(100, 5);
+    EXPECT_TRUE(mon.enableGoertzelBPM());
+    // Reconfigured for the sampling rate
+    mon.setSamplingRate(200);
+    auto trace = make_ppg(200, 10.f);
+    for (auto&& s : trace) {
+        mon.push_back(s.ir, s.red);
+    }
+    mon.update();
+    EXPECT_NEAR(mon.bpm(), 72.f, 72.f * 0.03f);
+    mon.clear();
+    mon.update();
+    EXPECT_EQ(mon.bpm(), 0.0f);
+    mon.disableGoertzelBPM();
+    EXPECT_FALSE(mon.inGoertzelBPM());
+}
+
+TEST(PulseMonitor, AutocorrelationBPM)
+{
+    struct Case {
+        uint32_t rate;
+        float bpm;
+        float wander;
+    };
+    // Strong baseline wander is left by the 5 Hz high-pass
+    const Case cases[] = {{100, 72.f, 300.f}, {100, 48.f, 300.f},  {200, 150.f, 300.f},
+                          {400, 96.f, 300.f}, {100, 72.f, 6000.f}, {400, 60.f, 6000.f}};
+    for (auto&& c : cases) {
+        SCOPED_TRACE(std::to_string(c.rate) + "sps " + std::to_string(c.bpm) + "bpm " + std::to_string(c.wander));
+        PPGParams params{};
+        params.bpm    = c.bpm;
+        params.wander = c.wander;
+        auto trace    = make_ppg(c.rate, 20.f, params);
+
+        PulseMonitor mon(c.rate, 8);
+        EXPECT_TRUE(mon.enableAutocorrelationBPM());
+        EXPECT_TRUE(mon.inAutocorrelationBPM());
+        uint32_t n{};
+        for (auto&& s : trace) {
+            mon.push_back(s.ir, s.red);
+            mon.update();
+            // Not before the window is filled
+            if (++n < c.rate * 8) {
+                EXPECT_EQ(mon.bpm(), 0.0f);
+            }
+        }
+        EXPECT_NEAR(mon.bpm(), c.bpm, c.bpm * 0.03f);
+    }
+
+    // The running sums are exact, the same as the sums over only the latest window
+    {
+        constexpr uint32_t rate{100};
+        auto trace = make_ppg(rate, 120.f);
+        AutocorrelationBPM whole(rate, rate * 5), latest(rate, rate * 5);
+        Filter fw(5.0f, rate);
+        const size_t from = trace.size() - (whole.window() + whole.maxLag());
+        for (size_t i = 0; i < trace.size(); ++i) {
+            const float v = fw.process(trace[i].ir);
+            whole.push_back(v);
+            if (i >= from) {
+                latest.push_back(v);
+            }
+        }
+        EXPECT_GT(whole.bpm(), 0.0f);
+        EXPECT_EQ(whole.bpm(), latest.bpm());
+    }
+
+    // Window shorter than the lag of 40 BPM
+    PulseMonitor mon(100, 1);
+    EXPECT_FALSE(mon.enableAutocorrelationBPM());
+    EXPECT_FALSE(mon.inAutocorrelationBPM());
+
+    // Exclusive with the Goertzel bank
+    PulseMonitor both(100, 5);
+    EXPECT_TRUE(both.enableGoertzelBPM());
+    EXPECT_TRUE(both.enableAutocorrelationBPM());
+    EXPECT_FALSE(both.inGoertzelBPM());
+    EXPECT_TRUE(both.enableGoertzelBPM());
+    EXPECT_FALSE(both.inAutocorrelationBPM());
+    both.disableGoertzelBPM();
+}
+
+TEST(PulseMonitor, Gap)
+{
+    constexpr uint32_t rate{100};
+
+    // Lost samples of a linear ramp are restored exactly
+    {
+        PulseMonitor reference(rate), monitor(rate);
+        for (uint32_t i = 0; i < 50; ++i) {
+            reference.push_back(1000.0f + i * 10.0f, 800.0f + i * 8.0f);
+            if (i < 20 || i >= 30) {
+                monitor.push_back(1000.0f + i * 10.0f, 800.0f + i * 8.0f);
+            } else if (i == 20) {
+                monitor.markGap(10);
+            }
+        }
+        EXPECT_NEAR(monitor.latestIR(), reference.latestIR(), 1e-3f);
+    }
+
+    // Drop 15 samples every 1.5 sec
+    PPGParams params{};
+    params.bpm         = 72.f;
+    params.variability = 0.0f;
+    auto trace         = make_ppg(rate, 20.f, params);
+
+    PulseMonitor continuous(rate), marked(rate), unmarked(rate);
+    for (size_t i = 0; i < trace.size(); ++i) {
+        continuous.push_back(trace[i].ir, trace[i].red);
+        if (i % 150 >= 135) {
+            if (i % 150 == 135) {
+                marked.markGap(15);
+            }
+            continue;
+        }
+        marked.push_back(trace[i].ir, trace[i].red);
+        unmarked.push_back(trace[i].ir, trace[i].red);
+    }
+    continuous.update();
+    marked.update();
+    unmarked.update();
+    EXPECT_NEAR(continuous.bpm(), 72.f, 2.0f);
+    EXPECT_NEAR(marked.bpm(), continuous.bpm(), 2.0f);
+    // The stream treated as continuous is faster by the lost samples
+    EXPECT_GT(unmarked.bpm(), 76.f);
+
+    // Longer than maxGap() clears
+    EXPECT_FLOAT_EQ(marked.maxGap(), 0.2f);
+    marked.markGap(rate);
+    EXPECT_FLOAT_EQ(marked.bpm(), 0.0f);
+    EXPECT_TRUE(std::isnan(marked.latestIR()));
+    marked.setMaxGap(2.0f);
+    EXPECT_FLOAT_EQ(marked.maxGap(), 2.0f);
+}
+
+TEST(Span, Basic)
+{
+    int arr[] = {1, 2, 3, 4, 5};
+    Span<int> s(arr);
+    EXPECT_EQ(s.size(), 5U);
+    EXPECT_FALSE(s.empty());
+    EXPECT_EQ(s.front(), 1);
+    EXPECT_EQ(s.back(), 5);
+    EXPECT_EQ(s.first(2).back(), 2);
+    EXPECT_EQ(s.last(2).front(), 4);
+
+    int sum{};
+    Span<const int> cs = s;
+    for (auto&& v : cs) {
+        sum += v;
+    }
+    EXPECT_EQ(sum, 15);
+    s[0] = 10;
+    EXPECT_EQ(cs[0], 10);
+
+    Span<const int> empty{};
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.begin(), empty.end());
+}
+
+TEST(FixedPulseMonitor, MatchesFloat)
+{
+    // MAX30102 (18 bits) and MAX30100 (16 bits) levels
+    for (const uint32_t max_value : {0x3FFFFU, 0xFFFFU}) {
+        for (auto&& c : conditions) {
+            SCOPED_TRACE(std::to_string(max_value) + " " + std::to_string(c.rate) + "sps " + std::to_string(c.sec) +
+                         "sec " + std::to_string(c.bpm));
+
+            PPGParams params{};
+            params.bpm       = c.bpm;
+            params.seed      = c.seed;
+            params.max_value = max_value;
+            if (max_value == 0xFFFFU) {
+                params.ir_dc  = 30000.f;
+                params.red_dc = 20000.f;
+            }
+            auto trace = make_ppg(c.rate, 30.f, params);
+
+            PulseMonitor monitor(c.rate, c.sec);
+            FixedPulseMonitor fixed(c.rate, c.sec);
+            uint32_t n{}, spo2s{};
+            for (auto&& s : trace) {
+                monitor.push_back(s.ir, s.red);
+                monitor.update();
+                fixed.push_back(s.ir, s.red);
+                fixed.update();
+
+                // After the window is filled
+                if (++n > c.rate * c.sec && monitor.bpm() > 0.0f) {
+                    EXPECT_NEAR(fixed.bpm(), monitor.bpm(), 1.0f);
+                }
+                if (n % c.rate == 0) {
+                    EXPECT_NEAR(fixed.SpO2(), monitor.SpO2(), 0.5f);
+                    ++spo2s;
+                }
+                EXPECT_NEAR(fixed.latestIR(), monitor.latestIR(), 4.0f);  // Quantization of the coefficients
+            }
+            EXPECT_GT(spo2s, 0U);
+            EXPECT_NEAR(fixed.bpm(), monitor.bpm(), 1.0f);
+        }
+    }
+
+    FixedPulseMonitor fixed(100, 2);
+    EXPECT_TRUE(std::isnan(fixed.latestIR()));
+    fixed.push_back(50000, 40000);
+    fixed.update();
+    EXPECT_FALSE(std::isnan(fixed.latestIR()));
+    fixed.setSamplingRate(200);
+    EXPECT_TRUE(std::isnan(fixed.latestIR()));
+    EXPECT_EQ(fixed.bpmQ8(), 0U);
+}
+
+TEST(FixedPulseMonitor, SharedChain)
+{
+    constexpr uint32_t rate{100};
+    PPGParams params{};
+    params.bpm         = 72.f;
+    params.variability = 0.0f;
+    auto trace         = make_ppg(rate, 20.f, params);
+
+    // The optional calculations of the chain, same as PulseMonitor
+    PulseMonitor sliding(rate), beat(rate), goertzel(rate), gap(rate);
+    FixedPulseMonitor fsliding(rate), fbeat(rate), fgoertzel(rate), fgap(rate), fblock(rate);
+    EXPECT_TRUE(sliding.enableSlidingSpO2(rate * 4, rate / 10));
+    EXPECT_TRUE(fsliding.enableSlidingSpO2(rate * 4, rate / 10));
+    EXPECT_TRUE(beat.enableBeatSpO2(4));
+    EXPECT_TRUE(fbeat.enableBeatSpO2(4));
+    EXPECT_TRUE(goertzel.enableGoertzelBPM());
+    EXPECT_TRUE(fgoertzel.enableGoertzelBPM());
+
+    std::vector<uint32_t> irs, reds;
+    for (size_t i = 0; i < trace.size(); ++i) {
+        const auto& s = trace[i];
+        irs.push_back(static_cast<uint32_t>(s.ir));
+        reds.push_back(static_cast<uint32_t>(s.red));
+        for (auto&& m : {&sliding, &beat, &goertzel}) {
+            m->push_back(s.ir, s.red);
+            m->update();
+        }
+        for (auto&& m : {&fsliding, &fbeat, &fgoertzel}) {
+            m->push_back(s.ir, s.red);
+            m->update();
+        }
+        // Drop 15 samples every 1.5 sec
+        if (i % 150 >= 135) {
+            if (i % 150 == 135) {
+                gap.markGap(15);
+                fgap.markGap(15);
+            }
+            continue;
+        }
+        gap.push_back(s.ir, s.red);
+        fgap.push_back(s.ir, s.red);
+        // After settled
+        if (i > rate * 5) {
+            EXPECT_NEAR(fsliding.SpO2(), sliding.SpO2(), 0.5f);
+            EXPECT_NEAR(fbeat.SpO2(), beat.SpO2(), 0.5f);
+        }
+    }
+    EXPECT_GE(fsliding.SpO2(), 80.f);
+    EXPECT_GE(fbeat.SpO2(), 80.f);
+    gap.update();
+    fgap.update();
+    EXPECT_NEAR(fgap.bpm(), gap.bpm(), 1.0f);
+    EXPECT_NEAR(fgoertzel.bpm(), goertzel.bpm(), 1.0f);
+    EXPECT_NEAR(fgoertzel.bpmQ8() / 256.0f, fgoertzel.bpm(), 0.01f);
+    EXPECT_NEAR(fbeat.SpO2Q8() / 256.0f, fbeat.SpO2(), 0.01f);
+
+    // process() is the same as push_back() and update() for each sample
+    EXPECT_GT(fblock.process(irs.data(), reds.data(), irs.size()), 0U);
+    EXPECT_EQ(fblock.bpmQ8(), fsliding.bpmQ8());
+    EXPECT_EQ(fblock.latestIR(), fsliding.latestIR());
+}